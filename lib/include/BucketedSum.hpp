@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class BucketedSum
+/// @brief exact sum of a stream of ratios, grouped by denominator : the numerators of each denominator are summed
+/// with plain integer additions (in the wide type), and the buckets are combined only once, by lcm, when the result is read.
+/// The number of gcds is the number of distinct denominators instead of the number of ratios.
+/// The wide sums are checked : an overflow is reported by the overflow policy of the result.
+/// @tparam T can be : int, long int
+template<class T>
+class BucketedSum {
+
+private :
+	/// @brief wide integer type of the sums of numerators
+	using W = wider_t<T> ;
+
+	/// @brief (denominator, sum of the numerators) of each distinct denominator
+	std::vector<std::pair<T, W>> _buckets ;
+	/// @brief position of each denominator in _buckets
+	std::unordered_map<T, std::size_t> _positions ;
+	/// @brief bucket of the last ratio added, checked first since equal denominators often come in runs
+	std::size_t _last ;
+	/// @brief a sum of numerators overflowed the wide type
+	bool _overflow ;
+
+	/// @brief report an overflow according to the policy of the result, Wrap cannot represent it and throws std::overflow_error
+	template<class OverflowPolicy>
+	static Ratio<T, OverflowPolicy> overflowed()
+	{
+		if constexpr (OverflowPolicy::detects_overflow) return OverflowPolicy::template on_overflow<Ratio<T, OverflowPolicy>>() ;
+		else throw std::overflow_error("BucketedSum: the sum does not fit in the integer type") ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor, the sum is zero
+	BucketedSum()
+	: _buckets(), _positions(), _last(0), _overflow(false) {}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief add a ratio
+	/// @param r the ratio, with a non null denominator
+	template<class OverflowPolicy>
+	void add(const Ratio<T, OverflowPolicy>& r)
+	{
+		assert( (r.get_denominator() != 0) && "error: infinite ratio");
+		const T den = r.get_denominator() ;
+		if(_last >= _buckets.size() || _buckets[_last].first != den){
+			const auto it = _positions.find(den) ;
+			if(it == _positions.end()){
+				_last = _buckets.size() ;
+				_positions.emplace(den, _last) ;
+				_buckets.emplace_back(den, 0) ;
+			}
+			else _last = it->second ;
+		}
+		_buckets[_last].second = overflow::detail::checked_add(_buckets[_last].second, static_cast<W>(r.get_numerator()), _overflow) ;
+	}
+
+	/// @brief add a range of ratios
+	/// @param first iterator to the first ratio
+	/// @param last iterator after the last ratio
+	template<class Iterator>
+	void add(Iterator first, const Iterator last)
+	{
+		for(; first != last; ++first) add(*first) ;
+	}
+
+	/// @brief number of distinct denominators seen
+	std::size_t nb_buckets() const noexcept{ return _buckets.size() ; }
+
+	/// @brief exact sum of the ratios added so far
+	/// @tparam OverflowPolicy policy of the result, which also reports an overflow of the wide sums (default : Wrap, which throws std::overflow_error)
+	/// @return the buckets combined over the lcm of their denominators
+	template<class OverflowPolicy = overflow::Wrap>
+	Ratio<T, OverflowPolicy> result() const
+	{
+		bool overflow = _overflow ;
+		W num = 0 ;
+		W den = 1 ;
+		for(const std::pair<T, W>& bucket : _buckets){
+			const W bucket_den = static_cast<W>(bucket.first) ;
+			const W pgcd = ratio_gcd(den, bucket_den) ;
+			num = overflow::detail::checked_add(overflow::detail::checked_mul(num, bucket_den / pgcd, overflow),
+			                                    overflow::detail::checked_mul(bucket.second, den / pgcd, overflow), overflow) ;
+			den = overflow::detail::checked_mul(den, bucket_den / pgcd, overflow) ;
+		}
+		if(overflow) return overflowed<OverflowPolicy>() ;
+
+		const Ratio<T, OverflowPolicy> sum = Ratio<T, OverflowPolicy>::reduce_wide(num, den, overflow) ;
+		if(overflow) return overflowed<OverflowPolicy>() ;
+		return sum ;
+	}
+};
+
+
+namespace bucketed_detail {
+
+	/// @brief integer type and overflow policy of a Ratio
+	template<class R>
+	struct ratio_traits ;
+
+	template<class T, class OverflowPolicy>
+	struct ratio_traits<Ratio<T, OverflowPolicy>> {
+		using integer_type = T ;
+		using policy = OverflowPolicy ;
+	};
+
+}
+
+/// @brief exact sum of a range of ratios, bucketed by denominator (see BucketedSum)
+/// @param first iterator to the first ratio
+/// @param last iterator after the last ratio
+/// @return the sum of the ratios, with their overflow policy
+template<class Iterator>
+auto bucketed_sum(const Iterator first, const Iterator last)
+{
+	using traits = bucketed_detail::ratio_traits<typename std::iterator_traits<Iterator>::value_type> ;
+	BucketedSum<typename traits::integer_type> sum ;
+	sum.add(first, last) ;
+	return sum.template result<typename traits::policy>() ;
+}
+
+/// @brief exact sum of an array of ratios, bucketed by denominator (see BucketedSum)
+/// @param ratios the ratios
+/// @param count number of ratios
+/// @return the sum of the ratios, with their overflow policy
+template<class T, class OverflowPolicy>
+Ratio<T, OverflowPolicy> bucketed_sum(const Ratio<T, OverflowPolicy>* ratios, const std::size_t count)
+{
+	return bucketed_sum(ratios, ratios + count) ;
+}
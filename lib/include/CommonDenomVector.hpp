@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class CommonDenomVector
+/// @brief vector of ratios sharing one denominator : only the integer numerators are stored.
+/// Adding or subtracting 2 vectors with the same denominator is a plain integer loop (vectorized by the compiler),
+/// the elements become individual Ratio only on demand.
+/// The integer operations are checked : std::overflow_error is thrown when a numerator or the common denominator
+/// no longer fits in T, the elements being then left in an unspecified state.
+/// The loops wrap, and detect the overflows with reductions which vectorize too : the sign bits for the additions,
+/// the extreme numerators for the multiplications, the halves of the numerators for the sum.
+/// @tparam T can be : int, long int
+template<class T>
+class CommonDenomVector {
+
+private :
+	/// @brief numerators of the elements
+	std::vector<T> _numerators ;
+	/// @brief common denominator, positive
+	T _denominator ;
+
+	/// @brief throw std::overflow_error if an operation overflowed
+	static void check(const bool overflow)
+	{
+		if(overflow) throw std::overflow_error("CommonDenomVector: integer overflow") ;
+	}
+
+	/// @brief a * b, throws std::overflow_error if it does not fit in T
+	static T mul(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_mul(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief multiply every numerator by factor, throws std::overflow_error before any change if one product does not fit in T
+	void scale(const T factor)
+	{
+		// the products are monotonic : only the extreme ones can overflow
+		T low = 0, high = 0 ;
+		for(const T num : _numerators){
+			low = std::min(low, num) ;
+			high = std::max(high, num) ;
+		}
+		mul(low, factor) ;
+		mul(high, factor) ;
+		bool unused = false ;
+		for(T& num : _numerators) num = overflow::Wrap::mul(num, factor, unused) ;
+	}
+
+	/// @brief least common multiple of 2 positive denominators, throws std::overflow_error if it does not fit in T
+	static T lcm(const T a, const T b)
+	{
+		return mul(a / ratio_gcd(a, b), b) ;
+	}
+
+	/// @brief numerator of r over the common denominator, which must be a multiple of the denominator of r
+	T scaled_numerator(const Ratio<T>& r) const
+	{
+		return mul(r.get_numerator(), _denominator / r.get_denominator()) ;
+	}
+
+	/// @brief rescale the vector if needed so that r can be written over the common denominator
+	void make_room_for(const Ratio<T>& r)
+	{
+		assert( (r.get_denominator() != 0) && "error: infinite element");
+		if(_denominator % r.get_denominator() != 0) rescale(lcm(_denominator, r.get_denominator())) ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief empty vector
+	/// @param denominator common denominator (default : 1)
+	explicit CommonDenomVector(const T denominator = 1)
+	: _numerators(), _denominator(denominator) {
+		assert( (denominator > 0) && "error: the common denominator must be positive");
+	}
+
+	/// @brief vector of size zeros
+	/// @param size number of elements
+	/// @param denominator common denominator
+	CommonDenomVector(const std::size_t size, const T denominator)
+	: _numerators(size, 0), _denominator(denominator) {
+		assert( (denominator > 0) && "error: the common denominator must be positive");
+	}
+
+
+/*------------------- GETTERS ---------------------*/
+
+	/// @brief number of elements
+	std::size_t size() const noexcept{ return _numerators.size() ; }
+
+	/// @brief common denominator
+	T denominator() const noexcept{ return _denominator ; }
+
+	/// @brief numerators of the elements, over the common denominator
+	const T* numerators() const noexcept{ return _numerators.data() ; }
+
+	/// @brief element i as an irreducible ratio
+	/// @param i index of the element
+	Ratio<T> operator[] (const std::size_t i) const
+	noexcept{
+		assert( (i < _numerators.size()) && "error: index out of range");
+		return Ratio<T>(_numerators[i], _denominator) ;
+	}
+
+	/// @brief set the element i, the vector is rescaled if the denominator of r does not divide the common one
+	/// @param i index of the element
+	/// @param r the new value
+	void set(const std::size_t i, const Ratio<T>& r)
+	{
+		assert( (i < _numerators.size()) && "error: index out of range");
+		make_room_for(r) ;
+		_numerators[i] = scaled_numerator(r) ;
+	}
+
+	/// @brief append an element, the vector is rescaled if the denominator of r does not divide the common one
+	/// @param r the new element
+	void push_back(const Ratio<T>& r)
+	{
+		make_room_for(r) ;
+		_numerators.push_back(scaled_numerator(r)) ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief change the common denominator, in bulk
+	/// @param denominator the new common denominator, a multiple of the current one
+	void rescale(const T denominator)
+	{
+		assert( (denominator % _denominator == 0) && "error: the new denominator must be a multiple of the current one");
+		const T factor = denominator / _denominator ;
+		if(factor == 1) return ;
+		scale(factor) ;
+		_denominator = denominator ;
+	}
+
+	/// @brief divide the common denominator by the gcd of all the numerators and itself
+	void compact()
+	noexcept{
+		T pgcd = _denominator ;
+		for(const T num : _numerators){
+			pgcd = ratio_gcd(pgcd, num) ;
+			if(pgcd == 1) return ;
+		}
+		for(T& num : _numerators) num /= pgcd ;
+		_denominator /= pgcd ;
+	}
+
+	/// @brief exact sum of the elements
+	/// @return the sum of the numerators over the common denominator
+	Ratio<T> sum() const
+	{
+		// each numerator is high * 2^half + low with 0 <= low < 2^half : the halves of up to chunk numerators
+		// are summed without overflow, so the inner loop needs no check
+		constexpr int half = (std::numeric_limits<T>::digits + 1) / 2 ;
+		constexpr T mask = (static_cast<T>(1) << half) - 1 ;
+		constexpr std::size_t chunk = std::size_t(1) << (half - 1) ;
+		bool overflow = false ;
+		T high = 0, low = 0 ;
+		for(std::size_t begin = 0; begin < _numerators.size(); begin += chunk){
+			const std::size_t end = std::min(_numerators.size(), begin + chunk) ;
+			T chunk_high = 0, chunk_low = 0 ;
+			for(std::size_t i = begin; i < end; ++i){
+				chunk_high += _numerators[i] >> half ;
+				chunk_low += _numerators[i] & mask ;
+			}
+			high = overflow::detail::checked_add(high, chunk_high, overflow) ;
+			low = overflow::detail::checked_add(low, chunk_low, overflow) ;
+		}
+		high = overflow::detail::checked_add(high, low >> half, overflow) ;
+		const T shifted = overflow::detail::checked_mul(high, static_cast<T>(1) << half, overflow) ;
+		const T num = overflow::detail::checked_add(shifted, low & mask, overflow) ;
+		check(overflow) ;
+		return Ratio<T>(num, _denominator) ;
+	}
+
+
+/*------------------- OPERATOR ---------------------*/
+
+	/// @brief element-wise addition, both vectors are first brought to the lcm of their denominators
+	/// @param v vector of the same size
+	CommonDenomVector& operator+= (const CommonDenomVector& v)
+	{
+		assert( (v.size() == size()) && "error: vectors of different sizes");
+		if(v._denominator == _denominator){
+			// a + b overflows iff the sign of the wrapped sum differs from the signs of both a and b
+			bool unused = false ;
+			T signs = 0 ;
+			for(std::size_t i = 0; i < _numerators.size(); ++i){
+				const T a = _numerators[i], b = v._numerators[i] ;
+				const T sum = overflow::Wrap::add(a, b, unused) ;
+				signs |= (a ^ sum) & (b ^ sum) ;
+				_numerators[i] = sum ;
+			}
+			check(signs < 0) ;
+			return *this ;
+		}
+		CommonDenomVector tmp = v ;
+		const T common = lcm(_denominator, v._denominator) ;
+		rescale(common) ;
+		tmp.rescale(common) ;
+		return *this += tmp ;
+	}
+
+	/// @brief element-wise subtraction, both vectors are first brought to the lcm of their denominators
+	/// @param v vector of the same size
+	CommonDenomVector& operator-= (const CommonDenomVector& v)
+	{
+		assert( (v.size() == size()) && "error: vectors of different sizes");
+		if(v._denominator == _denominator){
+			// a - b overflows iff a and b have different signs and the sign of the wrapped difference is not the one of a
+			bool unused = false ;
+			T signs = 0 ;
+			for(std::size_t i = 0; i < _numerators.size(); ++i){
+				const T a = _numerators[i], b = v._numerators[i] ;
+				const T difference = overflow::Wrap::sub(a, b, unused) ;
+				signs |= (a ^ b) & (a ^ difference) ;
+				_numerators[i] = difference ;
+			}
+			check(signs < 0) ;
+			return *this ;
+		}
+		CommonDenomVector tmp = v ;
+		const T common = lcm(_denominator, v._denominator) ;
+		rescale(common) ;
+		tmp.rescale(common) ;
+		return *this -= tmp ;
+	}
+
+	/// @brief multiply every element by an integer
+	/// @param nb the factor
+	CommonDenomVector& operator*= (const T nb)
+	{
+		this->scale(nb) ;
+		return *this ;
+	}
+
+	/// @brief element-wise addition
+	friend CommonDenomVector operator+ (CommonDenomVector a, const CommonDenomVector& b){
+		a += b ;
+		return a ;
+	}
+
+	/// @brief element-wise subtraction
+	friend CommonDenomVector operator- (CommonDenomVector a, const CommonDenomVector& b){
+		a -= b ;
+		return a ;
+	}
+};
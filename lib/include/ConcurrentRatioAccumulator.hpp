@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+#include "DenominatorCompactor.hpp"
+
+
+
+/// @class ConcurrentRatioAccumulator
+/// @brief exact sum of ratios added concurrently by several threads.
+/// Each thread takes a shard of the accumulator (one cache line each) at its first add() and gives it back when it exits,
+/// the shards are merged exactly when the total is read.
+/// A thread alone on its shard updates it without any lock. If more threads than shards add at the same time,
+/// the extra ones share a spill shard and serialize on it : the accumulator is not lock-free in that case.
+/// A shard keeps the same denominator as long as the added ratios share it, so this common case needs no gcd.
+/// Optionally, each shard is compacted by its own DenominatorCompactor, to bound the denominators of long streams.
+/// @tparam T can be : int, long int
+template<class T>
+class ConcurrentRatioAccumulator {
+
+private :
+
+	/// @brief a value of a shard
+	struct Slot {
+		std::atomic<T> numerator{0} ;
+		std::atomic<T> denominator{1} ;
+	};
+
+	/// @brief partial sum of the threads of a shard, not necessarily irreducible.
+	/// The writer fills the slot which is not published, then publishes it by incrementing the version :
+	/// a reader never waits for a writer, it only retries if a whole update was published during its read.
+	struct alignas(64) Shard {
+		std::atomic<std::uint64_t> version{0} ;
+		Slot slots[2] ;
+		/// @brief true while a thread holds the shard
+		std::atomic<bool> owned{false} ;
+		/// @brief writer lock, only taken on the spill shard
+		std::atomic<bool> writing{false} ;
+		/// @brief only used by the writer of the shard
+		DenominatorCompactor<T> compactor ;
+	};
+
+	/// @brief shard of a thread in an accumulator
+	struct Registration {
+		std::uint64_t id ;
+		/// @brief keeps the shards alive until the shard is given back, if the thread outlives the accumulator
+		std::weak_ptr<Shard[]> shards ;
+		Shard* shard ;
+		/// @brief false on the spill shard, which is never given back
+		bool owner ;
+	};
+
+	/// @brief shards held by a thread, given back when it exits
+	struct ThreadShards {
+		std::vector<Registration> registrations ;
+
+		~ThreadShards()
+		noexcept{
+			for(Registration& registration : registrations){
+				if(!registration.owner) continue ;
+				const std::shared_ptr<Shard[]> shards = registration.shards.lock() ;
+				if(shards) registration.shard->owned.store(false, std::memory_order_release) ;
+			}
+		}
+	};
+
+	/// @brief the shards, the last one is the spill shard
+	std::shared_ptr<Shard[]> _shards ;
+	/// @brief number of shards, without the spill shard
+	std::size_t _nb_shards ;
+	/// @brief identifier of the accumulator in the registrations, never reused
+	std::uint64_t _id ;
+	/// @brief compactor of the shards, also applied to the partial merges of total()
+	DenominatorCompactor<T> _compactor ;
+
+	/// @brief shards held by the calling thread
+	static ThreadShards& thread_shards()
+	noexcept{
+		thread_local ThreadShards shards ;
+		return shards ;
+	}
+
+	/// @brief identifier of a new accumulator
+	static std::uint64_t next_id()
+	noexcept{
+		static std::atomic<std::uint64_t> id{0} ;
+		return id.fetch_add(1, std::memory_order_relaxed) ;
+	}
+
+	/// @brief shard of the calling thread, taken at its first call : the first free shard, or the spill shard
+	Shard& shard_of_thread(){
+		std::vector<Registration>& registrations = thread_shards().registrations ;
+		for(const Registration& registration : registrations){
+			if(registration.id == _id) return *registration.shard ;
+		}
+
+		// forget the accumulators which no longer exist
+		registrations.erase(std::remove_if(registrations.begin(), registrations.end(),
+			[](const Registration& registration){ return registration.shards.expired() ; }), registrations.end()) ;
+
+		for(std::size_t i = 0; i < _nb_shards; ++i){
+			bool owned = false ;
+			if(!_shards[i].owned.load(std::memory_order_relaxed) && _shards[i].owned.compare_exchange_strong(owned, true, std::memory_order_acquire)){
+				registrations.push_back(Registration{_id, _shards, &_shards[i], true}) ;
+				return _shards[i] ;
+			}
+		}
+		registrations.push_back(Registration{_id, _shards, &_shards[_nb_shards], false}) ;
+		return _shards[_nb_shards] ;
+	}
+
+	/// @brief consistent snapshot of a shard
+	static Ratio<T> read(const Shard& shard)
+	noexcept{
+		std::uint64_t before, after ;
+		T num, den ;
+		do {
+			before = shard.version.load(std::memory_order_acquire) ;
+			const Slot& slot = shard.slots[before & 1] ;
+			num = slot.numerator.load(std::memory_order_relaxed) ;
+			den = slot.denominator.load(std::memory_order_relaxed) ;
+			std::atomic_thread_fence(std::memory_order_acquire) ;
+			after = shard.version.load(std::memory_order_relaxed) ;
+		} while(before != after) ;
+		return Ratio<T>(num, den) ;
+	}
+
+	/// @brief add a ratio to a shard, by its only writer
+	static void update(Shard& shard, const Ratio<T>& r)
+	noexcept{
+		const std::uint64_t version = shard.version.load(std::memory_order_relaxed) ;
+		const Slot& current = shard.slots[version & 1] ;
+		Slot& next = shard.slots[(version + 1) & 1] ;
+		// the readers which see the new values of next also see a version after this one
+		std::atomic_thread_fence(std::memory_order_release) ;
+
+		const T num = current.numerator.load(std::memory_order_relaxed) ;
+		const T den = current.denominator.load(std::memory_order_relaxed) ;
+		const bool compaction_due = shard.compactor.tick() ;
+		bool overflow = false ;
+		const T same_den_sum = overflow::detail::checked_add(num, r.get_numerator(), overflow) ;
+		if(den == r.get_denominator() && !compaction_due && !overflow){
+			// same denominator : one integer addition, the shard is reduced when read
+			next.numerator.store(same_den_sum, std::memory_order_relaxed) ;
+			next.denominator.store(den, std::memory_order_relaxed) ;
+		}
+		else {
+			Ratio<T> sum = Ratio<T>(num, den) + r ;
+			if(compaction_due) shard.compactor.compact(sum) ;
+			next.numerator.store(sum.get_numerator(), std::memory_order_relaxed) ;
+			next.denominator.store(sum.get_denominator(), std::memory_order_relaxed) ;
+		}
+
+		shard.version.store(version + 1, std::memory_order_release) ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor, the sum is zero
+	/// @param nb_shards number of shards, one per thread is best (default : hardware concurrency)
+	explicit ConcurrentRatioAccumulator(std::size_t nb_shards = std::thread::hardware_concurrency())
+	: _shards(), _nb_shards(nb_shards == 0 ? 1 : nb_shards), _id(next_id()), _compactor() {
+		_shards.reset(new Shard[_nb_shards + 1]) ;
+	}
+
+	/// @brief constructor of an approximate sum : each shard is compacted by a copy of compactor
+	/// @param nb_shards number of shards
+	/// @param compactor maximal denominator and period of the compactions of each shard
+	ConcurrentRatioAccumulator(std::size_t nb_shards, const DenominatorCompactor<T>& compactor)
+	: ConcurrentRatioAccumulator(nb_shards) {
+		_compactor = compactor ;
+		for(std::size_t i = 0; i <= _nb_shards; ++i) _shards[i].compactor = compactor ;
+	}
+
+	ConcurrentRatioAccumulator(const ConcurrentRatioAccumulator&) = delete ;
+	ConcurrentRatioAccumulator& operator= (const ConcurrentRatioAccumulator&) = delete ;
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief add a ratio to the shard of the calling thread
+	/// @param r the ratio to add
+	/// @throw std::bad_alloc at the first call of a thread, if its registration cannot be allocated
+	void add(const Ratio<T>& r){
+		Shard& shard = this->shard_of_thread() ;
+		if(&shard != &_shards[_nb_shards]){
+			update(shard, r) ;
+			return ;
+		}
+
+		// spill shard : the writers take turns
+		while(shard.writing.exchange(true, std::memory_order_acquire)) std::this_thread::yield() ;
+		update(shard, r) ;
+		shard.writing.store(false, std::memory_order_release) ;
+	}
+
+	/// @brief exact sum of all the ratios added so far (approximate with compaction), can be called while other threads are adding
+	/// @return the merge of the shards
+	Ratio<T> total() const
+	noexcept{
+		DenominatorCompactor<T> merge = _compactor ;
+		Ratio<T> result = Ratio<T>::zero() ;
+		for(std::size_t i = 0; i <= _nb_shards; ++i){
+			result += read(_shards[i]) ;
+			merge.compact(result) ;
+		}
+		return result ;
+	}
+
+	/// @brief set the sum back to zero, must not be called while other threads are adding
+	void reset()
+	noexcept{
+		for(std::size_t i = 0; i <= _nb_shards; ++i){
+			for(Slot& slot : _shards[i].slots){
+				slot.numerator.store(0, std::memory_order_relaxed) ;
+				slot.denominator.store(1, std::memory_order_relaxed) ;
+			}
+			_shards[i].compactor.reset() ;
+		}
+	}
+
+	/// @brief bound of the error introduced by the compactions of all the shards, must not be called while other threads are adding
+	/// @return 0 for an exact sum
+	double error_bound() const
+	noexcept{
+		if(!_compactor.is_active()) return 0.0 ;
+		// the shards, then at most one compaction per merge in total()
+		double bound = static_cast<double>(_nb_shards + 1) / (2.0 * static_cast<double>(_compactor.max_den())) ;
+		for(std::size_t i = 0; i <= _nb_shards; ++i) bound += _shards[i].compactor.error_bound() ;
+		return bound ;
+	}
+
+	/// @brief number of shards, without the spill shard
+	std::size_t nb_shards() const noexcept{ return _nb_shards ; }
+};
@@ -0,0 +1,268 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class PartialQuotients
+/// @brief lazy range over the partial quotients [a0; a1, a2, ...] of the regular continued fraction of a ratio.
+/// Each quotient is one step of the Euclidean algorithm on (numerator, denominator) : O(1) per term, no gcd and no allocation.
+/// a0 is the floor of the ratio (negative for a negative ratio), the following quotients are positive.
+/// @tparam T can be : int, long int
+template<class T>
+class PartialQuotients {
+
+public :
+
+	/// @class iterator
+	/// @brief forward iterator over the partial quotients, holding the remaining complete quotient n/d
+	class iterator {
+
+	private :
+		/// @brief remaining complete quotient n/d, d == 0 at the end
+		T _n, _d ;
+		/// @brief current partial quotient, floor(n/d)
+		T _a ;
+
+		/// @brief floor of n/d, d being positive
+		static constexpr T floor_division(const T n, const T d)
+		noexcept{
+			const T q = n / d ;
+			return (n % d != 0 && n < 0) ? q - 1 : q ;
+		}
+
+	public :
+		using iterator_category = std::forward_iterator_tag ;
+		using value_type = T ;
+		using difference_type = std::ptrdiff_t ;
+		using pointer = void ;
+		using reference = T ;
+
+		/// @brief default constructor, end of any range
+		constexpr iterator()
+		noexcept : _n(0), _d(0), _a(0) {}
+
+		/// @brief constructor from the complete quotient n/d
+		/// @param n numerator
+		/// @param d denominator, positive (0 gives the end iterator)
+		constexpr iterator(const T n, const T d)
+		noexcept : _n(n), _d(d), _a(d != 0 ? floor_division(n, d) : 0) {}
+
+		/// @brief the current partial quotient
+		constexpr T operator* () const noexcept{ return _a ; }
+
+		/// @brief go to the next quotient : n/d becomes d/(n - a*d)
+		constexpr iterator& operator++ ()
+		noexcept{
+			const T r = _n - _a * _d ;
+			_n = _d ;
+			_d = r ;
+			_a = (r != 0) ? _n / r : 0 ;
+			return *this ;
+		}
+
+		constexpr iterator operator++ (int)
+		noexcept{
+			iterator it = *this ;
+			++(*this) ;
+			return it ;
+		}
+
+		/// @brief two iterators are equal if they hold the same complete quotient, all the end iterators being equal
+		constexpr bool operator== (const iterator& it) const
+		noexcept{
+			return _d == it._d && (_d == 0 || _n == it._n) ;
+		}
+
+		constexpr bool operator!= (const iterator& it) const
+		noexcept{
+			return !(*this == it) ;
+		}
+	};
+
+private :
+
+	/// @brief the expanded ratio
+	T _numerator, _denominator ;
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor from the ratio num/den
+	/// @param num numerator
+	/// @param den denominator, positive
+	constexpr PartialQuotients(const T num, const T den)
+	noexcept : _numerator(num), _denominator(den) {
+		assert( (den > 0) && "error: the denominator must be positive");
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	constexpr iterator begin() const noexcept{ return iterator(_numerator, _denominator) ; }
+	constexpr iterator end() const noexcept{ return iterator() ; }
+};
+
+
+/// @class Convergents
+/// @brief lazy range over the convergents p_k/q_k of a continued fraction, given by a range of partial quotients.
+/// Each convergent comes from the two previous ones (p_k = a_k*p_{k-1} + p_{k-2}), so it is irreducible without any gcd,
+/// and each one is a best approximation of the limit : the iteration can stop as soon as the error bound 1/(q_k*q_{k+1}) is met.
+/// @tparam QuotientIterator forward iterator over the partial quotients
+template<class QuotientIterator>
+class Convergents {
+
+public :
+	/// @brief integer type of the quotients
+	using T = typename std::iterator_traits<QuotientIterator>::value_type ;
+
+	/// @class iterator
+	/// @brief forward iterator over the convergents, holding the two last ones
+	class iterator {
+
+	private :
+		/// @brief next partial quotient
+		QuotientIterator _it ;
+		/// @brief end of the partial quotients
+		QuotientIterator _end ;
+		/// @brief convergents p0/q0 and p1/q1, p1/q1 being the current one
+		T _p0, _q0, _p1, _q1 ;
+
+	public :
+		using iterator_category = std::forward_iterator_tag ;
+		using value_type = Ratio<T> ;
+		using difference_type = std::ptrdiff_t ;
+		using pointer = void ;
+		using reference = Ratio<T> ;
+
+		/// @brief constructor from a range of partial quotients
+		/// @param first first partial quotient
+		/// @param last end of the partial quotients
+		constexpr iterator(const QuotientIterator first, const QuotientIterator last)
+		: _it(first), _end(last), _p0(0), _q0(1), _p1(1), _q1(0) {
+			++(*this) ;
+		}
+
+		/// @brief the current convergent, already irreducible
+		constexpr Ratio<T> operator* () const
+		noexcept{
+			return Ratio<T>(_p1, _q1, reduced_tag) ;
+		}
+
+		/// @brief go to the next convergent
+		constexpr iterator& operator++ ()
+		{
+			if(_it == _end){
+				// past the last convergent
+				_q1 = 0 ;
+				return *this ;
+			}
+			const T a = *_it ;
+			++_it ;
+			const T p2 = a * _p1 + _p0 ;
+			const T q2 = a * _q1 + _q0 ;
+			_p0 = _p1 ; _q0 = _q1 ;
+			_p1 = p2 ; _q1 = q2 ;
+			return *this ;
+		}
+
+		constexpr iterator operator++ (int)
+		{
+			iterator it = *this ;
+			++(*this) ;
+			return it ;
+		}
+
+		/// @brief two iterators are equal if they point to the same convergent, all the end iterators being equal
+		constexpr bool operator== (const iterator& it) const
+		{
+			return _q1 == it._q1 && (_q1 == 0 || (_p1 == it._p1 && _it == it._it)) ;
+		}
+
+		constexpr bool operator!= (const iterator& it) const
+		{
+			return !(*this == it) ;
+		}
+	};
+
+private :
+
+	/// @brief the partial quotients
+	QuotientIterator _first, _last ;
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor from a range of partial quotients
+	/// @param first first partial quotient
+	/// @param last end of the partial quotients
+	constexpr Convergents(const QuotientIterator first, const QuotientIterator last)
+	: _first(first), _last(last) {}
+
+
+/*------------------- METHODES ---------------------*/
+
+	constexpr iterator begin() const { return iterator(_first, _last) ; }
+	constexpr iterator end() const { return iterator(_last, _last) ; }
+};
+
+
+
+/*------------------- FUNCTIONS ---------------------*/
+
+/// @brief lazy range over the partial quotients of a ratio
+/// @param r the ratio, with a non null denominator
+/// @return a range yielding a0, a1, ... (e.g. 415/93 gives 4, 2, 6, 7)
+template<class T, class OverflowPolicy>
+constexpr PartialQuotients<T> to_continued_fraction(const Ratio<T, OverflowPolicy>& r)
+noexcept{
+	return PartialQuotients<T>(r.get_numerator(), r.get_denominator()) ;
+}
+
+/// @brief lazy range over the convergents of a range of partial quotients
+/// @param first first partial quotient
+/// @param last end of the partial quotients
+template<class QuotientIterator>
+constexpr Convergents<QuotientIterator> convergents(const QuotientIterator first, const QuotientIterator last)
+{
+	return Convergents<QuotientIterator>(first, last) ;
+}
+
+/// @brief lazy range over the convergents of a ratio, the last one being the ratio itself
+/// @param r the ratio, with a non null denominator
+template<class T, class OverflowPolicy>
+constexpr Convergents<typename PartialQuotients<T>::iterator> convergents(const Ratio<T, OverflowPolicy>& r)
+noexcept{
+	const PartialQuotients<T> quotients = to_continued_fraction(r) ;
+	return Convergents<typename PartialQuotients<T>::iterator>(quotients.begin(), quotients.end()) ;
+}
+
+/// @brief the ratio [a0; a1, ..., an] of a finite continued fraction, evaluated from the front without gcd.
+/// The integers of the last convergent must fit in the type of the quotients.
+/// @param first first partial quotient
+/// @param last end of the partial quotients, the range being non empty
+/// @return the irreducible ratio
+template<class QuotientIterator>
+constexpr auto from_continued_fraction(const QuotientIterator first, const QuotientIterator last)
+{
+	assert( (first != last) && "error: empty continued fraction");
+	using T = typename std::iterator_traits<QuotientIterator>::value_type ;
+	Ratio<T> result ;
+	for(const Ratio<T>& convergent : convergents(first, last)) result = convergent ;
+	return result ;
+}
+
+/// @brief the ratio of a finite continued fraction (see above)
+/// @param quotients range of partial quotients : a container, or the result of to_continued_fraction
+template<class Range>
+constexpr auto from_continued_fraction(const Range& quotients)
+{
+	using std::begin ;
+	using std::end ;
+	return from_continued_fraction(begin(quotients), end(quotients)) ;
+}
@@ -0,0 +1,265 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#include "Ratio.hpp"
+#include "Rounding.hpp"
+
+
+
+// exact conversions between ratios and decimal text, in the style of std::from_chars / std::to_chars :
+// they read or write a caller's buffer, never allocate, and report errors by std::errc.
+//
+//   "12.50"       <-> 25/2
+//   "0.(142857)"  <-> 1/7      (the digits in parentheses repeat forever)
+//   "0.1(6)"      <-> 1/6
+
+namespace decimal_detail {
+
+	/// @brief 10^k, set overflow to true if it does not fit in U
+	template<class U>
+	constexpr U power_of_ten(const std::size_t k, bool& overflow)
+	noexcept{
+		U result = 1 ;
+		for(std::size_t i = 0; i < k && !overflow; ++i) result = overflow::detail::checked_mul(result, static_cast<U>(10), overflow) ;
+		return result ;
+	}
+
+	/// @brief append the decimal digit c to x, set overflow to true if x*10 + c does not fit in U
+	template<class U>
+	constexpr U append_digit(const U x, const char c, bool& overflow)
+	noexcept{
+		return overflow::detail::checked_add(overflow::detail::checked_mul(x, static_cast<U>(10), overflow), static_cast<U>(c - '0'), overflow) ;
+	}
+
+	/// @brief next digit of the long division rem/d : the digit is (10*rem)/d and rem becomes (10*rem) mod d
+	template<class U>
+	constexpr unsigned next_digit(U& rem, const U d)
+	noexcept{
+		if constexpr (std::numeric_limits<U>::digits <= 32){
+			const unsigned long long x = static_cast<unsigned long long>(rem) * 10 ;
+			rem = static_cast<U>(x % d) ;
+			return static_cast<unsigned>(x / d) ;
+		}
+		else {
+			// 10*rem may not fit in U : it is accumulated modulo d by ten additions, counting the wraps
+			unsigned q = 0 ;
+			U acc = 0 ;
+			for(int i = 0; i < 10; ++i){
+				if(acc >= d - rem){
+					acc -= d - rem ;
+					++q ;
+				}
+				else acc += rem ;
+			}
+			rem = acc ;
+			return q ;
+		}
+	}
+
+	/// @brief sign of the ratio, always false for an unsigned T
+	template<class T, class OverflowPolicy>
+	constexpr bool is_negative(const Ratio<T, OverflowPolicy>& r)
+	noexcept{
+		if constexpr (std::is_signed<T>::value) return r.get_numerator() < static_cast<T>(0) ;
+		else {
+			static_cast<void>(r) ;
+			return false ;
+		}
+	}
+
+	/// @brief write the sign and the integer part of r, and compute the magnitude of the remainder
+	/// @return the end of the written characters, nullptr if the buffer is too small
+	template<class T, class OverflowPolicy>
+	char* write_integer_part(char* first, char* last, const Ratio<T, OverflowPolicy>& r, typename std::make_unsigned<T>::type& rem, typename std::make_unsigned<T>::type& den)
+	noexcept{
+		using U = typename std::make_unsigned<T>::type ;
+		const U n = ratio_magnitude(r.get_numerator()) ;
+		den = static_cast<U>(r.get_denominator()) ;
+		rem = n % den ;
+		if(is_negative(r)){
+			if(first == last) return nullptr ;
+			*first++ = '-' ;
+		}
+		const std::to_chars_result result = ratio_to_chars(first, last, static_cast<U>(n / den)) ;
+		return (result.ec == std::errc()) ? result.ptr : nullptr ;
+	}
+
+}
+
+
+/// @brief exact value of a decimal number : [-]digits[.digits][(digits)], the digits in parentheses repeating forever
+/// @param first start of the text
+/// @param last end of the text
+/// @param value the ratio read, irreducible (one gcd), unchanged in case of error
+/// @return ptr : first character not read ; ec : std::errc() on success, std::errc::invalid_argument if the text does not start
+/// with a decimal number, std::errc::result_out_of_range if its numerator or denominator does not fit in T
+template<class T, class OverflowPolicy>
+std::from_chars_result from_decimal_chars(const char* first, const char* last, Ratio<T, OverflowPolicy>& value)
+noexcept{
+	using U = typename std::make_unsigned<T>::type ;
+	auto is_digit = [](const char c){ return c >= '0' && c <= '9' ; } ;
+	const char* p = first ;
+	const bool negative = (p != last && *p == '-') ;
+	if(negative) ++p ;
+
+	// all the digits before the repeating part form the integer m, the value being m / 10^k
+	bool overflow = false ;
+	U m = 0 ;
+	std::size_t k = 0, nb_digits = 0, pending_zeros = 0 ;
+	for(; p != last && is_digit(*p); ++p, ++nb_digits) m = decimal_detail::append_digit(m, *p, overflow) ;
+	U repeating = 0 ;
+	std::size_t r = 0 ;
+	if(p != last && *p == '.'){
+		const char* q = p + 1 ;
+		for(; q != last && is_digit(*q); ++q, ++nb_digits){
+			// trailing zeros of the fraction do not change the value : they are only used if a nonzero digit follows
+			if(*q == '0'){
+				++pending_zeros ;
+				continue ;
+			}
+			for(; pending_zeros > 0; --pending_zeros, ++k) m = decimal_detail::append_digit(m, '0', overflow) ;
+			m = decimal_detail::append_digit(m, *q, overflow) ;
+			++k ;
+		}
+		// repeating part, only if it is well formed
+		if(q != last && *q == '(' && q + 1 != last && is_digit(q[1])){
+			const char* s = q + 1 ;
+			U rep = 0 ;
+			std::size_t len = 0 ;
+			bool rep_overflow = false ;
+			for(; s != last && is_digit(*s); ++s, ++len) rep = decimal_detail::append_digit(rep, *s, rep_overflow) ;
+			if(s != last && *s == ')'){
+				for(; pending_zeros > 0; --pending_zeros, ++k) m = decimal_detail::append_digit(m, '0', overflow) ;
+				repeating = rep ;
+				r = len ;
+				overflow |= rep_overflow ;
+				q = s + 1 ;
+			}
+		}
+		if(nb_digits > 0) p = q ;
+	}
+	if(nb_digits == 0) return {first, std::errc::invalid_argument} ;
+
+	// m / 10^k, or (m * (10^r - 1) + repeating) / (10^k * (10^r - 1)) with a repeating part of r digits
+	U num = m ;
+	U den = decimal_detail::power_of_ten<U>(k, overflow) ;
+	if(r > 0){
+		const U nines = static_cast<U>(decimal_detail::power_of_ten<U>(r, overflow) - 1) ;
+		num = overflow::detail::checked_add(overflow::detail::checked_mul(m, nines, overflow), repeating, overflow) ;
+		den = overflow::detail::checked_mul(den, nines, overflow) ;
+	}
+	constexpr U max = static_cast<U>(std::numeric_limits<T>::max()) ;
+	if(overflow || num > max || den > max) return {p, std::errc::result_out_of_range} ;
+	if constexpr (!std::is_signed<T>::value){
+		// an unsigned ratio only accepts -0
+		if(negative && num != 0) return {p, std::errc::result_out_of_range} ;
+		value = Ratio<T, OverflowPolicy>(static_cast<T>(num), static_cast<T>(den)) ;
+	}
+	else value = Ratio<T, OverflowPolicy>(negative ? -static_cast<T>(num) : static_cast<T>(num), static_cast<T>(den)) ;
+	return {p, std::errc()} ;
+}
+
+
+/// @brief exact decimal text of a ratio : the digits of a terminating expansion ("12.5"), or the repeating period in parentheses ("0.(142857)").
+/// The period starts after max(v2(d), v5(d)) digits and its length is the multiplicative order of 10 modulo d without its factors 2 and 5 :
+/// it is found by the long division itself, which stops when the remainder comes back to its value at the start of the period.
+/// @param first start of the buffer
+/// @param last end of the buffer
+/// @param r the ratio
+/// @return ptr : end of the text ; ec : std::errc() on success, std::errc::value_too_large (ptr == last) if the buffer is too small
+template<class T, class OverflowPolicy>
+std::to_chars_result to_decimal_chars(char* first, char* last, const Ratio<T, OverflowPolicy>& r)
+noexcept{
+	using U = typename std::make_unsigned<T>::type ;
+	const std::to_chars_result too_large{last, std::errc::value_too_large} ;
+	if(r.get_denominator() == 0){
+		if(last - first < 3) return too_large ;
+		std::memcpy(first, "inf", 3) ;
+		return {first + 3, std::errc()} ;
+	}
+
+	U rem = 0, den = 0 ;
+	char* p = decimal_detail::write_integer_part(first, last, r, rem, den) ;
+	if(p == nullptr) return too_large ;
+	if(rem == 0) return {p, std::errc()} ;
+
+	// length of the part before the period
+	std::size_t v2 = 0, v5 = 0 ;
+	for(U d = den; d % 2 == 0; d /= 2) ++v2 ;
+	for(U d = den; d % 5 == 0; d /= 5) ++v5 ;
+	const std::size_t preperiod = (v2 > v5) ? v2 : v5 ;
+
+	if(p == last) return too_large ;
+	*p++ = '.' ;
+	for(std::size_t i = 0; i < preperiod && rem != 0; ++i){
+		if(p == last) return too_large ;
+		*p++ = static_cast<char>('0' + decimal_detail::next_digit(rem, den)) ;
+	}
+	if(rem == 0) return {p, std::errc()} ;
+
+	if(p == last) return too_large ;
+	*p++ = '(' ;
+	const U start = rem ;
+	do {
+		if(p == last) return too_large ;
+		*p++ = static_cast<char>('0' + decimal_detail::next_digit(rem, den)) ;
+	} while(rem != start) ;
+	if(p == last) return too_large ;
+	*p++ = ')' ;
+	return {p, std::errc()} ;
+}
+
+
+/// @brief decimal text of a ratio with a fixed number of digits after the point, the last one rounded
+/// @param first start of the buffer
+/// @param last end of the buffer
+/// @param r the ratio
+/// @param digits number of digits after the point (no point if 0)
+/// @param mode rounding of the last digit (default : to the nearest, ties away from zero)
+/// @return ptr : end of the text ; ec : std::errc() on success, std::errc::value_too_large (ptr == last) if the buffer is too small
+template<class T, class OverflowPolicy>
+std::to_chars_result to_decimal_chars(char* first, char* last, const Ratio<T, OverflowPolicy>& r, const std::size_t digits, const Rounding mode = Rounding::nearest)
+noexcept{
+	using U = typename std::make_unsigned<T>::type ;
+	const std::to_chars_result too_large{last, std::errc::value_too_large} ;
+	if(r.get_denominator() == 0){
+		if(last - first < 3) return too_large ;
+		std::memcpy(first, "inf", 3) ;
+		return {first + 3, std::errc()} ;
+	}
+
+	U rem = 0, den = 0 ;
+	char* p = decimal_detail::write_integer_part(first, last, r, rem, den) ;
+	if(p == nullptr) return too_large ;
+	char* const integer_first = decimal_detail::is_negative(r) ? first + 1 : first ;
+	if(digits > 0){
+		if(static_cast<std::size_t>(last - p) < digits + 1) return too_large ;
+		*p++ = '.' ;
+		for(std::size_t i = 0; i < digits; ++i) *p++ = static_cast<char>('0' + decimal_detail::next_digit(rem, den)) ;
+	}
+
+	// the digits are truncated, the remainder rem/den decides the rounding of the last one
+	if(rem != 0 && rounds_away(rem, den, decimal_detail::is_negative(r), (p[-1] - '0') % 2 != 0, mode)){
+		char* c = p ;
+		while(c != integer_first){
+			--c ;
+			if(*c == '.') continue ;
+			if(*c != '9'){
+				++*c ;
+				return {p, std::errc()} ;
+			}
+			*c = '0' ;
+		}
+		// carry out of the integer part : 99.9 -> 100.0
+		if(p == last) return too_large ;
+		std::memmove(integer_first + 1, integer_first, static_cast<std::size_t>(p - integer_first)) ;
+		*integer_first = '1' ;
+		++p ;
+	}
+	return {p, std::errc()} ;
+}
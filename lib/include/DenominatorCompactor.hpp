@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class DenominatorCompactor
+/// @brief hook for accumulators : every period calls, replace the accumulated ratio by its best approximation
+/// with a denominator at most max_den (Ratio::limit_denominator), so that the denominators stay bounded.
+/// Each compaction moves the value by at most 1/(2*max_den).
+/// ConcurrentRatioAccumulator takes one per shard ; RatioStats and BucketedSum are exact by design and take none.
+/// @tparam T can be : int, long int
+template<class T>
+class DenominatorCompactor {
+
+private :
+	/// @brief maximal denominator kept after a compaction
+	T _max_den ;
+	/// @brief number of operations between 2 compactions
+	std::size_t _period ;
+	/// @brief operations since the last compaction
+	std::size_t _count ;
+	/// @brief number of compactions which changed the accumulator
+	std::size_t _nb_compactions ;
+
+public :
+
+	/// @brief constructor of a compactor which never compacts
+	constexpr DenominatorCompactor()
+	noexcept : _max_den(std::numeric_limits<T>::max()), _period(0), _count(0), _nb_compactions(0) {}
+
+	/// @brief constructor
+	/// @param max_den maximal denominator kept after a compaction
+	/// @param period number of operations between 2 compactions (default : 1, every operation)
+	constexpr explicit DenominatorCompactor(const T max_den, const std::size_t period = 1)
+	noexcept : _max_den(max_den), _period(period), _count(0), _nb_compactions(0) {
+		assert( (max_den >= 1) && "error: the maximal denominator must be at least 1");
+		assert( (period >= 1) && "error: the period must be at least 1");
+	}
+
+	/// @brief to call after each operation on the accumulator
+	/// @param acc the accumulator, compacted in place every period calls
+	template<class OverflowPolicy>
+	constexpr void operator() (Ratio<T, OverflowPolicy>& acc)
+	noexcept{
+		if(this->tick()) this->compact(acc) ;
+	}
+
+	/// @brief count an operation, for accumulators which do not keep an irreducible ratio between the compactions
+	/// @return true if a compaction is due, then call compact()
+	constexpr bool tick()
+	noexcept{
+		if(_period == 0 || ++_count < _period) return false ;
+		_count = 0 ;
+		return true ;
+	}
+
+	/// @brief compact the accumulator now
+	/// @param acc the accumulator, replaced by its best approximation if its denominator is too large
+	/// @return true if the accumulator changed
+	template<class OverflowPolicy>
+	constexpr bool compact(Ratio<T, OverflowPolicy>& acc)
+	noexcept{
+		if(acc.get_denominator() <= _max_den) return false ;
+		acc = acc.limit_denominator(_max_den) ;
+		++_nb_compactions ;
+		return true ;
+	}
+
+	/// @brief forget the operations and the compactions so far, when the accumulator is set back to zero
+	constexpr void reset()
+	noexcept{
+		_count = 0 ;
+		_nb_compactions = 0 ;
+	}
+
+	/// @brief false for the compactor which never compacts
+	constexpr bool is_active() const noexcept{ return _period != 0 ; }
+
+	/// @brief maximal denominator kept after a compaction
+	constexpr T max_den() const noexcept{ return _max_den ; }
+
+	/// @brief number of compactions which changed the accumulator
+	constexpr std::size_t nb_compactions() const noexcept{ return _nb_compactions ; }
+
+	/// @brief bound of the total error introduced by the compactions so far
+	/// @return nb_compactions / (2*max_den)
+	constexpr double error_bound() const
+	noexcept{
+		return static_cast<double>(_nb_compactions) / (2.0 * static_cast<double>(_max_den)) ;
+	}
+};
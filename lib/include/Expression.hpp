@@ -0,0 +1,306 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @brief operation of a node of an ExpressionGraph
+enum class Operation {
+	input,      ///< value given by ExpressionGraph::set
+	constant,   ///< fixed value
+	add,
+	sub,
+	mul,
+	div,
+	neg,
+	pow         ///< integer power
+};
+
+
+/// @class ExpressionGraph
+/// @brief formulas over ratios stored as a DAG of operations, evaluated once per change.
+/// The nodes are hash-consed : building an operation which already exists (same operation, same operands, a+b and b+a alike)
+/// gives back the existing node, so a subexpression shared by several formulas is evaluated once.
+/// Changing an input only marks the nodes depending on it : the next evaluation recomputes this dirty subgraph and nothing else,
+/// level by level (the nodes of a level are independent) and in parallel for the large levels.
+/// @tparam T can be : int, long int
+/// @tparam OverflowPolicy overflow policy of the ratios
+template<class T, class OverflowPolicy = overflow::Wrap>
+class ExpressionGraph {
+
+public :
+	/// @brief type of the values
+	using ratio_type = Ratio<T, OverflowPolicy> ;
+	/// @brief handle on a node
+	using node_type = std::size_t ;
+
+	/// @brief minimum number of nodes of a level evaluated by several threads
+	static constexpr std::size_t parallel_threshold = 256 ;
+
+private :
+
+	/// @brief no operand
+	static constexpr std::size_t none = static_cast<std::size_t>(-1) ;
+
+	/// @brief a node of the graph
+	struct Node {
+		Operation operation ;
+		/// @brief operands, none if unused
+		std::size_t lhs ;
+		std::size_t rhs ;
+		/// @brief exponent of Operation::pow
+		int exponent ;
+		/// @brief 0 for inputs and constants, 1 + the level of the deepest operand otherwise
+		std::size_t level ;
+	};
+
+	/// @brief identity of a node, for the hash-consing
+	struct Key {
+		Operation operation ;
+		std::size_t lhs ;
+		std::size_t rhs ;
+		int exponent ;
+		/// @brief value of a constant
+		T numerator ;
+		T denominator ;
+
+		bool operator== (const Key& k) const
+		noexcept{
+			return operation == k.operation && lhs == k.lhs && rhs == k.rhs && exponent == k.exponent && numerator == k.numerator && denominator == k.denominator ;
+		}
+	};
+
+	/// @brief hash of a key
+	struct KeyHash {
+		std::size_t operator() (const Key& k) const
+		noexcept{
+			std::size_t h = static_cast<std::size_t>(k.operation) ;
+			auto combine = [&h](const std::size_t x){ h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2) ; } ;
+			combine(k.lhs) ;
+			combine(k.rhs) ;
+			combine(static_cast<std::size_t>(k.exponent)) ;
+			combine(std::hash<T>()(k.numerator)) ;
+			combine(std::hash<T>()(k.denominator)) ;
+			return h ;
+		}
+	};
+
+	/// @brief the nodes, in topological order (the operands of a node are created before it)
+	std::vector<Node> _nodes ;
+	/// @brief value of each node, up to date if the node is not dirty
+	std::vector<ratio_type> _values ;
+	/// @brief nodes having each node as operand
+	std::vector<std::vector<std::size_t>> _users ;
+	/// @brief true if the value of the node must be recomputed ; the users of a dirty node are dirty
+	std::vector<char> _dirty ;
+	/// @brief the dirty nodes
+	std::vector<std::size_t> _stale ;
+	/// @brief existing operations and constants
+	std::unordered_map<Key, std::size_t, KeyHash> _index ;
+
+	/// @brief mark a node and all the nodes depending on it as dirty
+	void mark_dirty(const std::size_t n)
+	{
+		std::vector<std::size_t> stack(1, n) ;
+		while(!stack.empty()){
+			const std::size_t i = stack.back() ;
+			stack.pop_back() ;
+			if(_dirty[i]) continue ;
+			_dirty[i] = 1 ;
+			_stale.push_back(i) ;
+			for(const std::size_t user : _users[i]) stack.push_back(user) ;
+		}
+	}
+
+	/// @brief the node of key k, created if it does not exist yet
+	node_type find_or_create(const Key& k, const ratio_type& value)
+	{
+		if(k.operation != Operation::input){
+			const auto found = _index.find(k) ;
+			if(found != _index.end()) return found->second ;
+		}
+		const std::size_t n = _nodes.size() ;
+		std::size_t level = 0 ;
+		if(k.lhs != none) level = std::max(level, _nodes[k.lhs].level + 1) ;
+		if(k.rhs != none) level = std::max(level, _nodes[k.rhs].level + 1) ;
+		_nodes.push_back(Node{k.operation, k.lhs, k.rhs, k.exponent, level}) ;
+		_values.push_back(value) ;
+		_users.emplace_back() ;
+		_dirty.push_back(0) ;
+		if(k.lhs != none) _users[k.lhs].push_back(n) ;
+		if(k.rhs != none && k.rhs != k.lhs) _users[k.rhs].push_back(n) ;
+		if(k.operation != Operation::input) _index.emplace(k, n) ;
+		if(k.lhs != none) mark_dirty(n) ;
+		return n ;
+	}
+
+	/// @brief node of an operation
+	node_type operation(const Operation op, std::size_t a, std::size_t b, const int exponent = 0)
+	{
+		assert( (a < _nodes.size() && (b == none || b < _nodes.size())) && "error: unknown node");
+		// a+b and b+a are the same node
+		if((op == Operation::add || op == Operation::mul) && b < a) std::swap(a, b) ;
+		return find_or_create(Key{op, a, b, exponent, 0, 0}, ratio_type::zero()) ;
+	}
+
+	/// @brief compute the value of a node from the values of its operands
+	void compute(const std::size_t n)
+	{
+		const Node& node = _nodes[n] ;
+		switch(node.operation){
+			case Operation::input :
+			case Operation::constant :
+				break ;
+			case Operation::add : _values[n] = _values[node.lhs] + _values[node.rhs] ; break ;
+			case Operation::sub : _values[n] = _values[node.lhs] - _values[node.rhs] ; break ;
+			case Operation::mul : _values[n] = _values[node.lhs] * _values[node.rhs] ; break ;
+			case Operation::div : _values[n] = _values[node.lhs] / _values[node.rhs] ; break ;
+			case Operation::neg : _values[n] = -_values[node.lhs] ; break ;
+			case Operation::pow : _values[n] = ratio_type::pow(_values[node.lhs], node.exponent) ; break ;
+		}
+	}
+
+	/// @brief compute the nodes of a level, independent of each other. The threads take the nodes by chunks
+	/// from a shared counter, so a thread which is done with cheap nodes takes over the remaining ones.
+	void compute_level(const std::vector<std::size_t>& level, const std::size_t nb_threads)
+	{
+		if(nb_threads <= 1 || level.size() < parallel_threshold){
+			for(const std::size_t n : level) compute(n) ;
+			return ;
+		}
+		constexpr std::size_t chunk = 32 ;
+		std::atomic<std::size_t> next{0} ;
+		std::exception_ptr error ;
+		std::mutex error_mutex ;
+		auto work = [&](){
+			try {
+				for(std::size_t first = next.fetch_add(chunk); first < level.size(); first = next.fetch_add(chunk)){
+					const std::size_t last = std::min(first + chunk, level.size()) ;
+					for(std::size_t i = first; i < last; ++i) compute(level[i]) ;
+				}
+			}
+			catch(...){
+				std::lock_guard<std::mutex> lock(error_mutex) ;
+				if(!error) error = std::current_exception() ;
+				next.store(level.size()) ;
+			}
+		} ;
+		std::vector<std::thread> threads ;
+		const std::size_t nb = std::min(nb_threads, (level.size() + chunk - 1) / chunk) ;
+		for(std::size_t t = 1; t < nb; ++t) threads.emplace_back(work) ;
+		work() ;
+		for(std::thread& thread : threads) thread.join() ;
+		if(error) std::rethrow_exception(error) ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief empty graph
+	ExpressionGraph() = default ;
+
+
+/*------------------- NODES ---------------------*/
+
+	/// @brief new input, changed later with set
+	/// @param value initial value
+	node_type input(const ratio_type& value = ratio_type::zero())
+	{
+		return find_or_create(Key{Operation::input, none, none, 0, 0, 0}, value) ;
+	}
+
+	/// @brief constant node, shared by all the uses of the same value
+	/// @param value the constant
+	node_type constant(const ratio_type& value)
+	{
+		return find_or_create(Key{Operation::constant, none, none, 0, value.get_numerator(), value.get_denominator()}, value) ;
+	}
+
+	/// @brief node a + b
+	node_type add(const node_type a, const node_type b){ return operation(Operation::add, a, b) ; }
+
+	/// @brief node a - b
+	node_type sub(const node_type a, const node_type b){ return operation(Operation::sub, a, b) ; }
+
+	/// @brief node a * b
+	node_type mul(const node_type a, const node_type b){ return operation(Operation::mul, a, b) ; }
+
+	/// @brief node a / b
+	node_type div(const node_type a, const node_type b){ return operation(Operation::div, a, b) ; }
+
+	/// @brief node -a
+	node_type neg(const node_type a){ return operation(Operation::neg, a, none) ; }
+
+	/// @brief node a^n
+	/// @param a the base
+	/// @param n the exponent, negative for a power of the inverse
+	node_type pow(const node_type a, const int n){ return operation(Operation::pow, a, none, n) ; }
+
+
+/*------------------- GETTERS ---------------------*/
+
+	/// @brief number of nodes
+	std::size_t size() const noexcept{ return _nodes.size() ; }
+
+	/// @brief operation of a node
+	Operation operation_of(const node_type n) const
+	noexcept{
+		assert( (n < _nodes.size()) && "error: unknown node");
+		return _nodes[n].operation ;
+	}
+
+	/// @brief number of nodes to recompute at the next evaluation
+	std::size_t nb_dirty() const noexcept{ return _stale.size() ; }
+
+	/// @brief value of a node, the graph is evaluated first if the node is dirty
+	/// @param n the node
+	const ratio_type& value(const node_type n)
+	{
+		assert( (n < _nodes.size()) && "error: unknown node");
+		if(_dirty[n]) evaluate() ;
+		return _values[n] ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief change the value of an input, the nodes depending on it become dirty
+	/// @param n the input
+	/// @param value its new value
+	void set(const node_type n, const ratio_type& value)
+	{
+		assert( (n < _nodes.size() && _nodes[n].operation == Operation::input) && "error: the node is not an input");
+		if(_values[n] == value) return ;
+		_values[n] = value ;
+		for(const std::size_t user : _users[n]) mark_dirty(user) ;
+	}
+
+	/// @brief recompute the dirty nodes, level by level
+	/// @param nb_threads number of threads computing the large levels
+	/// @return the number of nodes recomputed
+	std::size_t evaluate(const std::size_t nb_threads = 1)
+	{
+		if(_stale.empty()) return 0 ;
+		std::size_t depth = 0 ;
+		for(const std::size_t n : _stale) depth = std::max(depth, _nodes[n].level) ;
+		std::vector<std::vector<std::size_t>> levels(depth + 1) ;
+		for(const std::size_t n : _stale) levels[_nodes[n].level].push_back(n) ;
+		for(const std::vector<std::size_t>& level : levels) compute_level(level, nb_threads) ;
+
+		const std::size_t nb = _stale.size() ;
+		for(const std::size_t n : _stale) _dirty[n] = 0 ;
+		_stale.clear() ;
+		return nb ;
+	}
+};
@@ -0,0 +1,219 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class FareySequence
+/// @brief lazy range over the Farey sequence F_n : the irreducible fractions of [0,1] (or of a sub-interval) whose denominator is at most n, in increasing order.
+/// Each term is deduced from the two previous ones (next-term recurrence), so the iteration needs no gcd and no allocation.
+/// @tparam T can be : int, long int
+template<class T>
+class FareySequence {
+
+public :
+
+	/// @class iterator
+	/// @brief bidirectional iterator over a Farey sequence, holding a term and its successor
+	class iterator {
+
+	private :
+		/// @brief order of the sequence
+		T _n ;
+		/// @brief current term a/b
+		T _a, _b ;
+		/// @brief successor c/d of the current term
+		T _c, _d ;
+
+	public :
+		using iterator_category = std::bidirectional_iterator_tag ;
+		using value_type = Ratio<T> ;
+		using difference_type = std::ptrdiff_t ;
+		using pointer = void ;
+		using reference = Ratio<T> ;
+
+		/// @brief default constructor, singular iterator
+		constexpr iterator()
+		noexcept : _n(1), _a(0), _b(1), _c(1), _d(1) {}
+
+		/// @brief constructor from 2 consecutive terms of F_n
+		/// @param n order of the sequence
+		/// @param a, b current term a/b
+		/// @param c, d successor c/d of the current term
+		constexpr iterator(const T n, const T a, const T b, const T c, const T d)
+		noexcept : _n(n), _a(a), _b(b), _c(c), _d(d) {}
+
+		/// @brief the current term, already irreducible
+		constexpr Ratio<T> operator* () const
+		noexcept{
+			return Ratio<T>(_a, _b, reduced_tag) ;
+		}
+
+		/// @brief go to the next term : (k*c - a) / (k*d - b) with k = (n + b) / d
+		constexpr iterator& operator++ ()
+		noexcept{
+			const T k = (_n + _b) / _d ;
+			const T e = k * _c - _a ;
+			const T f = k * _d - _b ;
+			_a = _c ; _b = _d ;
+			_c = e ; _d = f ;
+			return *this ;
+		}
+
+		/// @brief go to the previous term : (k*a - c) / (k*b - d) with k = (n + d) / b
+		constexpr iterator& operator-- ()
+		noexcept{
+			const T k = (_n + _d) / _b ;
+			const T e = k * _a - _c ;
+			const T f = k * _b - _d ;
+			_c = _a ; _d = _b ;
+			_a = e ; _b = f ;
+			return *this ;
+		}
+
+		constexpr iterator operator++ (int)
+		noexcept{
+			iterator it = *this ;
+			++(*this) ;
+			return it ;
+		}
+
+		constexpr iterator operator-- (int)
+		noexcept{
+			iterator it = *this ;
+			--(*this) ;
+			return it ;
+		}
+
+		/// @brief two iterators of the same sequence are equal if they point to the same term
+		constexpr bool operator== (const iterator& it) const
+		noexcept{
+			return _a == it._a && _b == it._b ;
+		}
+
+		constexpr bool operator!= (const iterator& it) const
+		noexcept{
+			return !(*this == it) ;
+		}
+	};
+
+	using reverse_iterator = std::reverse_iterator<iterator> ;
+
+
+private :
+
+	/// @brief order of the sequence
+	T _n ;
+	/// @brief first term of the range
+	iterator _begin ;
+	/// @brief term following the last one of the range
+	iterator _end ;
+
+	/// @brief the term following a/b in F_n, a/b being irreducible with b <= n.
+	/// It is the c/d such that b*c - a*d = 1 with d maximal, found with the extended Euclidean algorithm.
+	static constexpr iterator starting_at(const T n, const T a, const T b)
+	noexcept{
+		assert( (b > 0 && b <= n) && "error: the fraction is not a term of this Farey sequence");
+		// inverse of a modulo b
+		T r0 = ((a % b) + b) % b, r1 = b ;
+		T u0 = 1, u1 = 0 ;
+		while(r1 != 0){
+			const T q = r0 / r1 ;
+			const T r2 = r0 - q*r1 ; r0 = r1 ; r1 = r2 ;
+			const T u2 = u0 - q*u1 ; u0 = u1 ; u1 = u2 ;
+		}
+		// d = -a^-1 mod b, then the largest such d lower or equal to n
+		T d = (b == 1) ? 0 : ((-u0 % b) + b) % b ;
+		d += ((n - d) / b) * b ;
+		const T c = (1 + a*d) / b ;
+		return iterator(n, a, b, c, d) ;
+	}
+
+	/// @brief range [first, last) of F_n given by its iterators
+	constexpr FareySequence(const T n, const iterator first, const iterator last)
+	noexcept : _n(n), _begin(first), _end(last) {}
+
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief the whole Farey sequence F_n, from 0/1 to 1/1
+	/// @param n order of the sequence : maximal denominator
+	constexpr explicit FareySequence(const T n)
+	noexcept : FareySequence(n, Ratio<T>::zero(), Ratio<T>::one()) {}
+
+	/// @brief the terms of F_n between lo and hi (both included)
+	/// @param n order of the sequence : maximal denominator
+	/// @param lo first term, its denominator must be lower or equal to n
+	/// @param hi last term, its denominator must be lower or equal to n
+	constexpr FareySequence(const T n, Ratio<T> lo, Ratio<T> hi)
+	noexcept : _n(n), _begin(starting_at(n, lo.get_numerator(), lo.get_denominator())),
+	           _end(++starting_at(n, hi.get_numerator(), hi.get_denominator())) {
+		assert( (n > 0) && "error: the order of a Farey sequence is at least 1");
+		assert( (lo <= hi) && "error: empty interval");
+	}
+
+
+/*------------------- ITERATORS ---------------------*/
+
+	constexpr iterator begin() const noexcept{ return _begin ; }
+	constexpr iterator end() const noexcept{ return _end ; }
+	reverse_iterator rbegin() const noexcept{ return reverse_iterator(_end) ; }
+	reverse_iterator rend() const noexcept{ return reverse_iterator(_begin) ; }
+
+	/// @brief order of the sequence
+	constexpr T order() const noexcept{ return _n ; }
+
+
+/*------------------- PARALLEL ---------------------*/
+
+	/// @brief split F_n into consecutive sub-sequences, cut at the fractions j/parts
+	/// @param n order of the sequence
+	/// @param parts number of sub-sequences (at most n)
+	/// @return the sub-sequences, in increasing order, which together give F_n exactly once
+	static std::vector<FareySequence> partition(const T n, std::size_t parts)
+	{
+		assert( (n > 0 && parts > 0) && "error: empty partition");
+		if(parts > static_cast<std::size_t>(n)) parts = static_cast<std::size_t>(n) ;
+		const T nb = static_cast<T>(parts) ;
+
+		std::vector<FareySequence> result ;
+		result.reserve(parts) ;
+		iterator first = starting_at(n, 0, 1) ;
+		for(T j = 1; j <= nb; ++j){
+			const Ratio<T> cut(j, nb) ;
+			iterator last = starting_at(n, cut.get_numerator(), cut.get_denominator()) ;
+			if(j == nb) ++last ;
+			result.push_back(FareySequence(n, first, last)) ;
+			first = last ;
+		}
+		return result ;
+	}
+
+	/// @brief call f on every term of F_n, the sequence being split between several threads.
+	/// f is called concurrently and in no particular order.
+	/// @param n order of the sequence
+	/// @param f function called on each term, taking a Ratio<T>
+	/// @param nb_threads number of threads (default : hardware concurrency)
+	template<class Function>
+	static void for_each_parallel(const T n, Function f, std::size_t nb_threads = std::thread::hardware_concurrency())
+	{
+		if(nb_threads == 0) nb_threads = 1 ;
+		const std::vector<FareySequence> parts = partition(n, nb_threads) ;
+		std::vector<std::thread> threads ;
+		threads.reserve(parts.size()) ;
+		for(const FareySequence& part : parts){
+			threads.emplace_back([&part, &f](){
+				for(const Ratio<T> r : part) f(r) ;
+			}) ;
+		}
+		for(std::thread& thread : threads) thread.join() ;
+	}
+
+};
@@ -0,0 +1,218 @@
+#pragma once
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+#include "Ratio.hpp"
+#include "Rounding.hpp"
+
+
+
+/// @class Fixed
+/// @brief rational number with a denominator known at compile time (money in 1/100, time in 1/90000...) : only the numerator is stored.
+/// Addition and subtraction are one integer operation. Multiplication and division by another Fixed are rescaled by the constant Den,
+/// which the compiler turns into a multiply-shift ; their rounding is chosen by the caller (half_even by default).
+/// Every operation throws std::overflow_error when the numerator does not fit in T, except from_numerator.
+/// @tparam T can be : int, long int
+/// @tparam Den the denominator, positive
+template<class T, T Den>
+class Fixed {
+
+	static_assert(std::is_integral<T>::value, "Integral required.");
+	static_assert(Den > 0, "the denominator must be positive");
+
+private :
+	/// @brief numerator, the value is _numerator/Den
+	T _numerator ;
+
+	/// @brief tag of the constructor from a raw numerator
+	struct RawTag {} ;
+
+	constexpr Fixed(const T num, RawTag)
+	noexcept : _numerator(num) {}
+
+	/// @brief throw std::overflow_error if a numerator does not fit in T
+	static constexpr void check(const bool overflow)
+	{
+		if(overflow) throw std::overflow_error("Fixed: the numerator does not fit in the integer type") ;
+	}
+
+	/// @brief a+b, throws std::overflow_error if it does not fit in T
+	static constexpr T add(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_add(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief a-b, throws std::overflow_error if it does not fit in T
+	static constexpr T sub(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_sub(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief a*b, throws std::overflow_error if it does not fit in T
+	static constexpr T mul(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_mul(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief Den over the denominator of r, which must divide Den
+	static constexpr T multiple_of(const Ratio<T>& r)
+	noexcept{
+		assert( (r.get_denominator() != 0 && Den % r.get_denominator() == 0) && "error: the ratio is not a multiple of 1/Den, use from_ratio");
+		return Den / r.get_denominator() ;
+	}
+
+	/// @brief a*b/c rounded, computed in T when a*b fits, in the wide type otherwise
+	/// @return the quotient, throws std::overflow_error if it does not fit in T
+	static constexpr T mul_div(const T a, const T b, const T c, const Rounding mode)
+	{
+		bool overflowed = false ;
+		const T product = overflow::detail::checked_mul(a, b, overflowed) ;
+		if(!overflowed) return rounded_division(product, c, mode) ;
+		using W = wider_t<T> ;
+		const W quotient = rounded_division(static_cast<W>(a) * static_cast<W>(b), static_cast<W>(c), mode) ;
+		check(quotient > static_cast<W>(std::numeric_limits<T>::max()) || quotient < static_cast<W>(std::numeric_limits<T>::min())) ;
+		return static_cast<T>(quotient) ;
+	}
+
+public :
+
+	/// @brief rounding of the operators * and / between 2 Fixed
+	static constexpr Rounding default_rounding = Rounding::half_even ;
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief zero
+	constexpr Fixed()
+	noexcept : _numerator(0) {}
+
+	/// @brief constructor from an integer, throws std::overflow_error if nb*Den does not fit in T
+	/// @param nb the integer value
+	constexpr explicit Fixed(const T nb)
+	: _numerator(mul(nb, Den)) {}
+
+	/// @brief lossless constructor from a ratio, whose denominator must divide Den
+	/// @param r the ratio, throws std::overflow_error if its numerator over Den does not fit in T
+	constexpr explicit Fixed(const Ratio<T>& r)
+	: _numerator(mul(r.get_numerator(), multiple_of(r))) {}
+
+	/// @brief the Fixed whose numerator is num
+	/// @param num numerator over Den
+	constexpr static Fixed from_numerator(const T num)
+	noexcept{
+		return Fixed(num, RawTag{}) ;
+	}
+
+	/// @brief the multiple of 1/Den closest to a ratio, according to a rounding mode
+	/// @param r the ratio
+	/// @param mode rounding mode (default : half_even)
+	/// @return the Fixed, throws std::overflow_error if its numerator does not fit in T
+	constexpr static Fixed from_ratio(const Ratio<T>& r, const Rounding mode = default_rounding)
+	{
+		assert( (r.get_denominator() != 0) && "error: infinite ratio");
+		return Fixed(mul_div(r.get_numerator(), Den, r.get_denominator(), mode), RawTag{}) ;
+	}
+
+
+/*------------------- GETTERS ---------------------*/
+
+	/// @brief numerator over Den
+	constexpr T numerator() const noexcept{ return _numerator ; }
+
+	/// @brief the denominator Den
+	constexpr static T denominator() noexcept{ return Den ; }
+
+	/// @brief exact conversion to an irreducible ratio
+	constexpr Ratio<T> to_ratio() const
+	noexcept{
+		return Ratio<T>(_numerator, Den) ;
+	}
+
+	/// @brief exact conversion to an irreducible ratio
+	constexpr explicit operator Ratio<T>() const
+	noexcept{
+		return to_ratio() ;
+	}
+
+
+/*------------------- OPERATOR ---------------------*/
+
+	constexpr Fixed& operator+= (const Fixed& f){ _numerator = add(_numerator, f._numerator) ; return *this ; }
+	constexpr Fixed& operator-= (const Fixed& f){ _numerator = sub(_numerator, f._numerator) ; return *this ; }
+	constexpr Fixed& operator*= (const T nb){ _numerator = mul(_numerator, nb) ; return *this ; }
+
+	constexpr Fixed operator+ (const Fixed& f) const{ return Fixed(add(_numerator, f._numerator), RawTag{}) ; }
+	constexpr Fixed operator- (const Fixed& f) const{ return Fixed(sub(_numerator, f._numerator), RawTag{}) ; }
+	constexpr Fixed operator- () const{ return Fixed(sub(0, _numerator), RawTag{}) ; }
+	constexpr Fixed operator* (const T nb) const{ return Fixed(mul(_numerator, nb), RawTag{}) ; }
+
+	/// @brief product of 2 Fixed : (a*b)/Den, rounded
+	/// @param a a Fixed
+	/// @param b another Fixed
+	/// @param mode rounding mode
+	/// @return the product, throws std::overflow_error if its numerator does not fit in T
+	constexpr static Fixed multiply(const Fixed& a, const Fixed& b, const Rounding mode)
+	{
+		return Fixed(mul_div(a._numerator, b._numerator, Den, mode), RawTag{}) ;
+	}
+
+	/// @brief quotient of 2 Fixed : (a*Den)/b, rounded
+	/// @param a a Fixed
+	/// @param b another Fixed, not null
+	/// @param mode rounding mode
+	/// @return the quotient, throws std::overflow_error if its numerator does not fit in T
+	constexpr static Fixed divide(const Fixed& a, const Fixed& b, const Rounding mode)
+	{
+		assert( (b._numerator != 0) && "error: division by zero");
+		return Fixed(mul_div(a._numerator, Den, b._numerator, mode), RawTag{}) ;
+	}
+
+	/// @brief quotient of a Fixed by an integer, rounded
+	/// @param a a Fixed
+	/// @param nb integer, not null
+	/// @param mode rounding mode
+	/// @return the quotient, throws std::overflow_error if its numerator does not fit in T (the smallest numerator divided by -1)
+	constexpr static Fixed divide(const Fixed& a, const T nb, const Rounding mode)
+	{
+		assert( (nb != 0) && "error: division by zero");
+		check(nb == -1 && a._numerator == std::numeric_limits<T>::min()) ;
+		return Fixed(rounded_division(a._numerator, nb, mode), RawTag{}) ;
+	}
+
+	constexpr Fixed operator* (const Fixed& f) const{ return multiply(*this, f, default_rounding) ; }
+	constexpr Fixed operator/ (const Fixed& f) const{ return divide(*this, f, default_rounding) ; }
+	constexpr Fixed operator/ (const T nb) const{ return divide(*this, nb, default_rounding) ; }
+
+	constexpr bool operator== (const Fixed& f) const noexcept{ return _numerator == f._numerator ; }
+	constexpr bool operator!= (const Fixed& f) const noexcept{ return _numerator != f._numerator ; }
+	constexpr bool operator< (const Fixed& f) const noexcept{ return _numerator < f._numerator ; }
+	constexpr bool operator<= (const Fixed& f) const noexcept{ return _numerator <= f._numerator ; }
+	constexpr bool operator> (const Fixed& f) const noexcept{ return _numerator > f._numerator ; }
+	constexpr bool operator>= (const Fixed& f) const noexcept{ return _numerator >= f._numerator ; }
+
+
+/*------------------- FRIENDS METHODES ---------------------*/
+
+	/// \brief overload the operator << for Fixed
+    /// \param stream : input stream
+    /// \param f : the Fixed to output
+    /// \return the output stream containing the irreducible ratio
+	friend std::ostream& operator<< (std::ostream& stream, const Fixed& f) {
+		return stream << f.to_ratio() ;
+	}
+
+	/// @brief multiply an integer and a Fixed
+	friend constexpr Fixed operator* (const T nb, const Fixed& f){
+		return f * nb ;
+	}
+};
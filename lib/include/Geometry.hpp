@@ -0,0 +1,335 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "Ratio.hpp"
+
+#if !defined(__SIZEOF_INT128__)
+#error "Geometry.hpp requires a compiler with 128 bits integers"
+#endif
+
+
+
+/// @brief exact 2D geometry on points with rational coordinates.
+/// The predicates are first evaluated with interval arithmetic on doubles ; only when the interval contains 0
+/// they are evaluated exactly, on integers : each point is put on the common denominator of its coordinates
+/// (homogeneous coordinates) and the determinant is computed with fixed-size wide integers, without any gcd.
+namespace geometry {
+
+	/// @brief point with rational coordinates
+	/// @tparam T can be : int, long int, long long int
+	template<class T>
+	struct Point {
+		Ratio<T> x ;
+		Ratio<T> y ;
+	};
+
+	namespace detail {
+
+	/*------------------- INTERVAL FILTER ---------------------*/
+
+		/// @brief interval of doubles containing an exact value, each operation being rounded outward by one ulp
+		struct Interval {
+			double lo, hi ;
+
+			/// @brief interval containing a ratio : its correctly rounded double, widened by one ulp
+			template<class T>
+			static Interval of(const Ratio<T>& r)
+			noexcept{
+				const double d = r.to_double() ;
+				return Interval{std::nextafter(d, -std::numeric_limits<double>::infinity()), std::nextafter(d, std::numeric_limits<double>::infinity())} ;
+			}
+
+			static Interval outward(const double lo, const double hi)
+			noexcept{
+				return Interval{std::nextafter(lo, -std::numeric_limits<double>::infinity()), std::nextafter(hi, std::numeric_limits<double>::infinity())} ;
+			}
+
+			Interval operator+ (const Interval& i) const noexcept{ return outward(lo + i.lo, hi + i.hi) ; }
+			Interval operator- (const Interval& i) const noexcept{ return outward(lo - i.hi, hi - i.lo) ; }
+
+			Interval operator* (const Interval& i) const
+			noexcept{
+				const double a = lo * i.lo, b = lo * i.hi, c = hi * i.lo, d = hi * i.hi ;
+				return outward(std::min(std::min(a, b), std::min(c, d)), std::max(std::max(a, b), std::max(c, d))) ;
+			}
+
+			/// @brief sign of the exact value if the interval tells it, 2 otherwise (also for NaN bounds)
+			int sign() const
+			noexcept{
+				if(lo > 0) return 1 ;
+				if(hi < 0) return -1 ;
+				if(lo == 0 && hi == 0) return 0 ;
+				return 2 ;
+			}
+		};
+
+
+	/*------------------- FIXED SIZE INTEGERS ---------------------*/
+
+		/// @class FixedInt
+		/// @brief signed integer of N 64 bits words in two's complement : sums and products are computed modulo 2^(64N),
+		/// which gives the exact result as long as it fits
+		template<std::size_t N>
+		class FixedInt {
+
+		private :
+			/// @brief words, least significant first
+			std::array<std::uint64_t, N> _words ;
+
+		public :
+			/// @brief sign-extended constructor
+			constexpr FixedInt(const ratio_int128 x = 0)
+			noexcept : _words() {
+				const std::uint64_t extension = (x < 0) ? ~std::uint64_t(0) : 0 ;
+				_words[0] = static_cast<std::uint64_t>(x) ;
+				if(N > 1) _words[1] = static_cast<std::uint64_t>(static_cast<ratio_uint128>(x) >> 64) ;
+				for(std::size_t i = 2; i < N; ++i) _words[i] = extension ;
+			}
+
+			constexpr FixedInt operator+ (const FixedInt& b) const
+			noexcept{
+				FixedInt result ;
+				std::uint64_t carry = 0 ;
+				for(std::size_t i = 0; i < N; ++i){
+					const ratio_uint128 s = static_cast<ratio_uint128>(_words[i]) + b._words[i] + carry ;
+					result._words[i] = static_cast<std::uint64_t>(s) ;
+					carry = static_cast<std::uint64_t>(s >> 64) ;
+				}
+				return result ;
+			}
+
+			constexpr FixedInt operator- () const
+			noexcept{
+				FixedInt result ;
+				std::uint64_t carry = 1 ;
+				for(std::size_t i = 0; i < N; ++i){
+					const ratio_uint128 s = static_cast<ratio_uint128>(~_words[i]) + carry ;
+					result._words[i] = static_cast<std::uint64_t>(s) ;
+					carry = static_cast<std::uint64_t>(s >> 64) ;
+				}
+				return result ;
+			}
+
+			constexpr FixedInt operator- (const FixedInt& b) const noexcept{ return *this + (-b) ; }
+
+			constexpr FixedInt operator* (const FixedInt& b) const
+			noexcept{
+				FixedInt result ;
+				for(std::size_t i = 0; i < N; ++i){
+					if(_words[i] == 0) continue ;
+					std::uint64_t carry = 0 ;
+					for(std::size_t j = 0; i + j < N; ++j){
+						const ratio_uint128 t = static_cast<ratio_uint128>(_words[i]) * b._words[j] + result._words[i+j] + carry ;
+						result._words[i+j] = static_cast<std::uint64_t>(t) ;
+						carry = static_cast<std::uint64_t>(t >> 64) ;
+					}
+				}
+				return result ;
+			}
+
+			/// @brief -1, 0 or 1
+			constexpr int sign() const
+			noexcept{
+				if(_words[N-1] >> 63) return -1 ;
+				for(const std::uint64_t w : _words){
+					if(w != 0) return 1 ;
+				}
+				return 0 ;
+			}
+		};
+
+		/// @brief number of 64 bits words for the products of `degree` integers of 2*(digits of T + 1) bits, plus some sums
+		template<class T>
+		constexpr std::size_t nb_words(const std::size_t degree) noexcept{ return (degree * 2 * (std::numeric_limits<T>::digits + 1) + 8) / 64 + 1 ; }
+
+		/// @brief homogeneous coordinates (X, Y, W) of a point : x = X/W, y = Y/W, W = lcm of the denominators > 0
+		template<class T>
+		struct Homogeneous {
+			ratio_int128 X, Y, W ;
+
+			explicit Homogeneous(const Point<T>& p)
+			noexcept{
+				using Wide = wider_t<T> ;
+				const Wide xd = p.x.get_denominator(), yd = p.y.get_denominator() ;
+				const Wide g = std::gcd(xd, yd) ;
+				X = static_cast<ratio_int128>(p.x.get_numerator() * (yd / g)) ;
+				Y = static_cast<ratio_int128>(p.y.get_numerator() * (xd / g)) ;
+				W = static_cast<ratio_int128>(xd / g * yd) ;
+			}
+		};
+
+		template<class T>
+		int orientation_exact(const Point<T>& pa, const Point<T>& pb, const Point<T>& pc)
+		noexcept{
+			using I = FixedInt<nb_words<T>(3)> ;
+			const Homogeneous<T> a(pa), b(pb), c(pc) ;
+			const I ax(a.X), ay(a.Y), aw(a.W), bx(b.X), by(b.Y), bw(b.W), cx(c.X), cy(c.Y), cw(c.W) ;
+			// | ax ay aw |
+			// | bx by bw |  with aw, bw, cw > 0
+			// | cx cy cw |
+			const I det = ax * (by*cw - cy*bw) - ay * (bx*cw - cx*bw) + aw * (bx*cy - cx*by) ;
+			return det.sign() ;
+		}
+
+		template<class T>
+		int in_circle_exact(const Point<T>& pa, const Point<T>& pb, const Point<T>& pc, const Point<T>& pd)
+		noexcept{
+			using I = FixedInt<nb_words<T>(8)> ;
+			// row of a point (x, y) = (X/W, Y/W) : [x, y, x^2 + y^2, 1] multiplied by W^2 > 0
+			std::array<std::array<I, 4>, 4> m ;
+			const Point<T>* points[4] = {&pa, &pb, &pc, &pd} ;
+			for(std::size_t i = 0; i < 4; ++i){
+				const Homogeneous<T> h(*points[i]) ;
+				const I X(h.X), Y(h.Y), W(h.W) ;
+				m[i] = {X*W, Y*W, X*X + Y*Y, W*W} ;
+			}
+			// Laplace expansion along the rows (0,1) and (2,3)
+			auto minor = [&m](const std::size_t r, const std::size_t i, const std::size_t j){ return m[r][i] * m[r+1][j] - m[r][j] * m[r+1][i] ; } ;
+			const I det = minor(0,0,1) * minor(2,2,3) - minor(0,0,2) * minor(2,1,3) + minor(0,0,3) * minor(2,1,2)
+			            + minor(0,1,2) * minor(2,0,3) - minor(0,1,3) * minor(2,0,2) + minor(0,2,3) * minor(2,0,1) ;
+			return det.sign() ;
+		}
+
+		/// @brief ratio with the overflow policy Promote
+		template<class T>
+		Ratio<T, overflow::Promote> promote(const Ratio<T>& r) noexcept{ return Ratio<T, overflow::Promote>(r.get_numerator(), r.get_denominator(), reduced_tag) ; }
+
+		/// @brief ratio with the default overflow policy
+		template<class T>
+		Ratio<T> demote(const Ratio<T, overflow::Promote>& r) noexcept{ return Ratio<T>(r.get_numerator(), r.get_denominator(), reduced_tag) ; }
+
+		/// @brief lexicographic order (x, then y)
+		template<class T>
+		int compare(const Point<T>& a, const Point<T>& b)
+		noexcept{
+			const int cx = Ratio<T>::compare(a.x, b.x) ;
+			return (cx != 0) ? cx : Ratio<T>::compare(a.y, b.y) ;
+		}
+
+	}
+
+
+/*------------------- PREDICATES ---------------------*/
+
+	/// @brief orientation of the triangle (a, b, c)
+	/// @return 1 if counterclockwise, -1 if clockwise, 0 if the points are collinear
+	template<class T>
+	int orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c)
+	noexcept{
+		using detail::Interval ;
+		const Interval ax = Interval::of(a.x), ay = Interval::of(a.y) ;
+		const Interval det = (Interval::of(b.x) - ax) * (Interval::of(c.y) - ay) - (Interval::of(b.y) - ay) * (Interval::of(c.x) - ax) ;
+		const int s = det.sign() ;
+		return (s != 2) ? s : detail::orientation_exact(a, b, c) ;
+	}
+
+	/// @brief position of d relative to the circle through a, b, c (in counterclockwise order)
+	/// @return 1 if d is inside, -1 if outside, 0 if on the circle
+	template<class T>
+	int in_circle(const Point<T>& a, const Point<T>& b, const Point<T>& c, const Point<T>& d)
+	noexcept{
+		using detail::Interval ;
+		const Interval dx = Interval::of(d.x), dy = Interval::of(d.y) ;
+		const Interval adx = Interval::of(a.x) - dx, ady = Interval::of(a.y) - dy ;
+		const Interval bdx = Interval::of(b.x) - dx, bdy = Interval::of(b.y) - dy ;
+		const Interval cdx = Interval::of(c.x) - dx, cdy = Interval::of(c.y) - dy ;
+		const Interval a2 = adx*adx + ady*ady, b2 = bdx*bdx + bdy*bdy, c2 = cdx*cdx + cdy*cdy ;
+		const Interval det = adx * (bdy*c2 - b2*cdy) - ady * (bdx*c2 - b2*cdx) + a2 * (bdx*cdy - bdy*cdx) ;
+		const int s = det.sign() ;
+		return (s != 2) ? s : detail::in_circle_exact(a, b, c, d) ;
+	}
+
+
+/*------------------- SEGMENTS ---------------------*/
+
+	/// @brief true if q, collinear with p and r, lies on the segment [p, r]
+	template<class T>
+	bool on_segment(const Point<T>& p, const Point<T>& q, const Point<T>& r)
+	noexcept{
+		auto between = [](const Ratio<T>& lo, const Ratio<T>& x, const Ratio<T>& hi){
+			return (Ratio<T>::compare(lo, x) <= 0 && Ratio<T>::compare(x, hi) <= 0) || (Ratio<T>::compare(hi, x) <= 0 && Ratio<T>::compare(x, lo) <= 0) ;
+		} ;
+		return between(p.x, q.x, r.x) && between(p.y, q.y, r.y) ;
+	}
+
+	/// @brief true if the closed segments [p1, p2] and [q1, q2] have at least one common point
+	template<class T>
+	bool intersects(const Point<T>& p1, const Point<T>& p2, const Point<T>& q1, const Point<T>& q2)
+	noexcept{
+		const int o1 = orientation(p1, p2, q1), o2 = orientation(p1, p2, q2) ;
+		const int o3 = orientation(q1, q2, p1), o4 = orientation(q1, q2, p2) ;
+		if(o1 * o2 < 0 && o3 * o4 < 0) return true ;
+		return (o1 == 0 && on_segment(p1, q1, p2)) || (o2 == 0 && on_segment(p1, q2, p2))
+		    || (o3 == 0 && on_segment(q1, p1, q2)) || (o4 == 0 && on_segment(q1, p2, q2)) ;
+	}
+
+	/// @brief the common point of the segments [p1, p2] and [q1, q2], if there is exactly one.
+	/// It is computed with the overflow policy Promote : throws std::overflow_error if its coordinates do not fit in T.
+	/// @param out the intersection point
+	/// @return false if the segments do not intersect, or overlap on more than one point
+	template<class T>
+	bool intersection(const Point<T>& p1, const Point<T>& p2, const Point<T>& q1, const Point<T>& q2, Point<T>& out)
+	{
+		if(!intersects(p1, p2, q1, q2)) return false ;
+
+		if(orientation(p1, p2, q1) == 0 && orientation(p1, p2, q2) == 0){
+			// collinear : the overlap is [max of the lower ends, min of the upper ends]
+			const Point<T>& lo1 = (detail::compare(p1, p2) <= 0) ? p1 : p2 ;
+			const Point<T>& hi1 = (detail::compare(p1, p2) <= 0) ? p2 : p1 ;
+			const Point<T>& lo2 = (detail::compare(q1, q2) <= 0) ? q1 : q2 ;
+			const Point<T>& hi2 = (detail::compare(q1, q2) <= 0) ? q2 : q1 ;
+			const Point<T>& lo = (detail::compare(lo1, lo2) >= 0) ? lo1 : lo2 ;
+			const Point<T>& hi = (detail::compare(hi1, hi2) <= 0) ? hi1 : hi2 ;
+			if(detail::compare(lo, hi) != 0) return false ;
+			out = lo ;
+			return true ;
+		}
+
+		// p1 + t (p2 - p1) with t = cross(q1 - p1, q2 - q1) / cross(p2 - p1, q2 - q1)
+		using detail::promote ;
+		const auto rx = promote(p2.x) - promote(p1.x), ry = promote(p2.y) - promote(p1.y) ;
+		const auto sx = promote(q2.x) - promote(q1.x), sy = promote(q2.y) - promote(q1.y) ;
+		const auto wx = promote(q1.x) - promote(p1.x), wy = promote(q1.y) - promote(p1.y) ;
+		const auto t = (wx*sy - wy*sx) / (rx*sy - ry*sx) ;
+		out = Point<T>{detail::demote(promote(p1.x) + t*rx), detail::demote(promote(p1.y) + t*ry)} ;
+		return true ;
+	}
+
+
+/*------------------- CONVEX HULL ---------------------*/
+
+	/// @brief exact convex hull (monotone chain)
+	/// @param points the points, in any order
+	/// @return the vertices of the hull in counterclockwise order, starting from the lowest x (then lowest y), without collinear points
+	template<class T>
+	std::vector<Point<T>> convex_hull(std::vector<Point<T>> points)
+	{
+		std::sort(points.begin(), points.end(), [](const Point<T>& a, const Point<T>& b){ return detail::compare(a, b) < 0 ; }) ;
+		points.erase(std::unique(points.begin(), points.end(), [](const Point<T>& a, const Point<T>& b){ return detail::compare(a, b) == 0 ; }), points.end()) ;
+		if(points.size() < 3) return points ;
+
+		std::vector<Point<T>> hull(2 * points.size()) ;
+		std::size_t k = 0 ;
+		// lower hull
+		for(std::size_t i = 0; i < points.size(); ++i){
+			while(k >= 2 && orientation(hull[k-2], hull[k-1], points[i]) <= 0) --k ;
+			hull[k++] = points[i] ;
+		}
+		// upper hull
+		const std::size_t lower = k + 1 ;
+		for(std::size_t i = points.size() - 1; i > 0; --i){
+			while(k >= lower && orientation(hull[k-2], hull[k-1], points[i-1]) <= 0) --k ;
+			hull[k++] = points[i-1] ;
+		}
+		hull.resize(k - 1) ;
+		return hull ;
+	}
+
+}
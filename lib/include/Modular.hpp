@@ -0,0 +1,642 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+#if !defined(__SIZEOF_INT128__)
+#error "Modular.hpp requires a compiler with 128 bits integers"
+#endif
+
+
+
+/// @brief multi-modular exact linear algebra : the problem is solved modulo several primes just below 2^63,
+/// the residues are combined by the chinese remainder theorem and the ratios are recovered by rational reconstruction.
+/// The reconstruction stops as soon as the result is stable from one prime to the next one, so small results need few primes.
+namespace modular {
+
+	namespace detail {
+
+		/// @brief a^e mod m
+		constexpr std::uint64_t pow_mod(std::uint64_t a, std::uint64_t e, const std::uint64_t m)
+		noexcept{
+			std::uint64_t result = 1 % m ;
+			a %= m ;
+			while(e > 0){
+				if(e & 1) result = static_cast<std::uint64_t>(static_cast<ratio_uint128>(result) * a % m) ;
+				a = static_cast<std::uint64_t>(static_cast<ratio_uint128>(a) * a % m) ;
+				e >>= 1 ;
+			}
+			return result ;
+		}
+
+		/// @brief deterministic Miller-Rabin test, exact for every 64 bits integer
+		constexpr bool is_prime(const std::uint64_t n)
+		noexcept{
+			if(n < 2) return false ;
+			constexpr std::uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37} ;
+			for(const std::uint64_t b : bases){
+				if(n % b == 0) return n == b ;
+			}
+			std::uint64_t d = n - 1 ;
+			int s = 0 ;
+			while((d & 1) == 0){
+				d >>= 1 ;
+				++s ;
+			}
+			for(const std::uint64_t b : bases){
+				std::uint64_t x = pow_mod(b, d, n) ;
+				if(x == 1 || x == n - 1) continue ;
+				bool composite = true ;
+				for(int i = 1; i < s && composite; ++i){
+					x = static_cast<std::uint64_t>(static_cast<ratio_uint128>(x) * x % n) ;
+					composite = (x != n - 1) ;
+				}
+				if(composite) return false ;
+			}
+			return true ;
+		}
+
+
+		/// @class Natural
+		/// @brief fixed capacity unsigned integer (384 bits), just what the chinese remainder and the rational reconstruction need
+		class Natural {
+
+		public :
+			/// @brief number of 64 bits words
+			static constexpr std::size_t nb_words = 6 ;
+
+		private :
+			/// @brief words, least significant first
+			std::array<std::uint64_t, nb_words> _words ;
+
+		public :
+			constexpr Natural(const std::uint64_t x = 0)
+			noexcept : _words{x, 0, 0, 0, 0, 0} {}
+
+			/// @brief number of significant bits
+			constexpr std::size_t bit_length() const
+			noexcept{
+				for(std::size_t i = nb_words; i > 0; --i){
+					if(_words[i-1] != 0) return 64*(i-1) + 64 - static_cast<std::size_t>(__builtin_clzll(_words[i-1])) ;
+				}
+				return 0 ;
+			}
+
+			constexpr bool is_zero() const noexcept{ return bit_length() == 0 ; }
+
+			/// @brief the 128 low bits
+			constexpr ratio_uint128 low128() const
+			noexcept{
+				return (static_cast<ratio_uint128>(_words[1]) << 64) | _words[0] ;
+			}
+
+			/// @brief remainder of the division by m
+			constexpr std::uint64_t mod(const std::uint64_t m) const
+			noexcept{
+				ratio_uint128 r = 0 ;
+				for(std::size_t i = nb_words; i > 0; --i) r = ((r << 64) | _words[i-1]) % m ;
+				return static_cast<std::uint64_t>(r) ;
+			}
+
+			/// @brief this * m, which must fit in the capacity
+			constexpr Natural operator* (const std::uint64_t m) const
+			noexcept{
+				Natural result ;
+				ratio_uint128 carry = 0 ;
+				for(std::size_t i = 0; i < nb_words; ++i){
+					carry += static_cast<ratio_uint128>(_words[i]) * m ;
+					result._words[i] = static_cast<std::uint64_t>(carry) ;
+					carry >>= 64 ;
+				}
+				assert( (carry == 0) && "error: modular::detail::Natural capacity exceeded");
+				return result ;
+			}
+
+			constexpr Natural& operator+= (const Natural& n)
+			noexcept{
+				std::uint64_t carry = 0 ;
+				for(std::size_t i = 0; i < nb_words; ++i){
+					const ratio_uint128 s = static_cast<ratio_uint128>(_words[i]) + n._words[i] + carry ;
+					_words[i] = static_cast<std::uint64_t>(s) ;
+					carry = static_cast<std::uint64_t>(s >> 64) ;
+				}
+				assert( (carry == 0) && "error: modular::detail::Natural capacity exceeded");
+				return *this ;
+			}
+
+			/// @brief this - n, n being not greater than this
+			constexpr Natural& operator-= (const Natural& n)
+			noexcept{
+				std::uint64_t borrow = 0 ;
+				for(std::size_t i = 0; i < nb_words; ++i){
+					const std::uint64_t a = _words[i] ;
+					const std::uint64_t b = n._words[i] + borrow ;
+					borrow = (b < borrow || a < b) ? 1 : 0 ;
+					_words[i] = a - b ;
+				}
+				return *this ;
+			}
+
+			/// @brief this * 2^shift, which must fit in the capacity
+			constexpr Natural operator<< (const std::size_t shift) const
+			noexcept{
+				Natural result ;
+				const std::size_t words = shift / 64, bits = shift % 64 ;
+				for(std::size_t i = nb_words; i > words; --i){
+					const std::size_t j = i - 1 - words ;
+					std::uint64_t w = _words[j] << bits ;
+					if(bits != 0 && j > 0) w |= _words[j-1] >> (64 - bits) ;
+					result._words[i-1] = w ;
+				}
+				return result ;
+			}
+
+			constexpr bool operator<= (const Natural& n) const
+			noexcept{
+				for(std::size_t i = nb_words; i > 0; --i){
+					if(_words[i-1] != n._words[i-1]) return _words[i-1] < n._words[i-1] ;
+				}
+				return true ;
+			}
+		};
+
+	}
+
+
+/*------------------- PRIMES ---------------------*/
+
+	/// @brief the k-th prime below 2^63, in decreasing order (prime(0) = 2^63 - 25), computed once and cached
+	/// @param k rank of the prime
+	inline std::uint64_t prime(const std::size_t k)
+	{
+		static std::mutex mutex ;
+		static std::vector<std::uint64_t> primes ;
+		std::lock_guard<std::mutex> lock(mutex) ;
+		while(primes.size() <= k){
+			std::uint64_t candidate = primes.empty() ? (std::uint64_t(1) << 63) - 1 : primes.back() - 2 ;
+			while(!detail::is_prime(candidate)) candidate -= 2 ;
+			primes.push_back(candidate) ;
+		}
+		return primes[k] ;
+	}
+
+
+/*------------------- FIELD ---------------------*/
+
+	/// @class Field
+	/// @brief arithmetic modulo an odd prime p < 2^63, in Montgomery form : the residue x is stored as x*2^64 mod p,
+	/// so a product is one 64x64->128 bits multiplication and one reduction without division
+	class Field {
+
+	private :
+		/// @brief the prime
+		std::uint64_t _p ;
+		/// @brief -p^-1 mod 2^64
+		std::uint64_t _p_neg_inv ;
+		/// @brief 2^128 mod p, to enter the Montgomery form
+		std::uint64_t _r2 ;
+
+		/// @brief t * 2^-64 mod p, for t < p * 2^64
+		constexpr std::uint64_t reduce(const ratio_uint128 t) const
+		noexcept{
+			const std::uint64_t m = static_cast<std::uint64_t>(t) * _p_neg_inv ;
+			const std::uint64_t u = static_cast<std::uint64_t>((t + static_cast<ratio_uint128>(m) * _p) >> 64) ;
+			return (u >= _p) ? u - _p : u ;
+		}
+
+	public :
+
+	/*------------------- CONSTRUCT0R ---------------------*/
+
+		/// @brief constructor
+		/// @param p an odd prime below 2^63
+		constexpr explicit Field(const std::uint64_t p)
+		noexcept : _p(p), _p_neg_inv(0), _r2(0) {
+			assert( ((p & 1) == 1 && p < (std::uint64_t(1) << 63)) && "error: the modulus must be odd and below 2^63");
+			// Newton iteration : each step doubles the number of correct low bits of p^-1
+			std::uint64_t inv = p ;
+			for(int i = 0; i < 5; ++i) inv *= 2 - p * inv ;
+			_p_neg_inv = ~inv + 1 ;
+			const std::uint64_t r = (~p + 1) % p ;   // 2^64 mod p
+			_r2 = static_cast<std::uint64_t>(static_cast<ratio_uint128>(r) * r % p) ;
+		}
+
+
+	/*------------------- METHODES ---------------------*/
+
+		/// @brief the prime
+		constexpr std::uint64_t modulus() const noexcept{ return _p ; }
+
+		constexpr std::uint64_t zero() const noexcept{ return 0 ; }
+		constexpr std::uint64_t one() const noexcept{ return from_unsigned(1) ; }
+
+		/// @brief Montgomery form of x mod p
+		constexpr std::uint64_t from_unsigned(const std::uint64_t x) const
+		noexcept{
+			return reduce(static_cast<ratio_uint128>(x % _p) * _r2) ;
+		}
+
+		/// @brief Montgomery form of an integer (up to 128 bits, any sign)
+		template<class T>
+		constexpr std::uint64_t from_integer(const T x) const
+		noexcept{
+			ratio_int128 r = static_cast<ratio_int128>(x) % static_cast<ratio_int128>(_p) ;
+			if(r < 0) r += _p ;
+			return from_unsigned(static_cast<std::uint64_t>(r)) ;
+		}
+
+		/// @brief Montgomery form of a ratio
+		/// @param r the ratio
+		/// @param x the residue of r
+		/// @return false if the denominator of r is a multiple of p (the ratio has no residue)
+		template<class T, class OverflowPolicy>
+		constexpr bool from_ratio(const Ratio<T, OverflowPolicy>& r, std::uint64_t& x) const
+		noexcept{
+			x = from_integer(r.get_numerator()) ;
+			if(r.get_denominator() == 1) return true ;
+			const std::uint64_t den = from_integer(r.get_denominator()) ;
+			if(den == 0) return false ;
+			x = mul(x, inverse(den)) ;
+			return true ;
+		}
+
+		/// @brief residue in [0, p) of a Montgomery form
+		constexpr std::uint64_t to_unsigned(const std::uint64_t x) const noexcept{ return reduce(x) ; }
+
+		constexpr std::uint64_t add(const std::uint64_t a, const std::uint64_t b) const
+		noexcept{
+			const std::uint64_t s = a + b ;
+			return (s >= _p) ? s - _p : s ;
+		}
+
+		constexpr std::uint64_t sub(const std::uint64_t a, const std::uint64_t b) const
+		noexcept{
+			return (a >= b) ? a - b : a + (_p - b) ;
+		}
+
+		constexpr std::uint64_t neg(const std::uint64_t a) const
+		noexcept{
+			return (a == 0) ? 0 : _p - a ;
+		}
+
+		constexpr std::uint64_t mul(const std::uint64_t a, const std::uint64_t b) const
+		noexcept{
+			return reduce(static_cast<ratio_uint128>(a) * b) ;
+		}
+
+		/// @brief a^e
+		constexpr std::uint64_t pow(std::uint64_t a, std::uint64_t e) const
+		noexcept{
+			std::uint64_t result = one() ;
+			while(e > 0){
+				if(e & 1) result = mul(result, a) ;
+				a = mul(a, a) ;
+				e >>= 1 ;
+			}
+			return result ;
+		}
+
+		/// @brief a^-1 = a^(p-2), a not null
+		constexpr std::uint64_t inverse(const std::uint64_t a) const
+		noexcept{
+			assert( (a != 0) && "error: zero has no inverse");
+			return pow(a, _p - 2) ;
+		}
+	};
+
+
+/*------------------- MATRIX ---------------------*/
+
+	/// @class Matrix
+	/// @brief dense matrix of residues modulo a prime (Montgomery form), stored row-major in one contiguous array
+	class Matrix {
+
+	private :
+		Field _field ;
+		std::size_t _nb_rows, _nb_cols ;
+		std::vector<std::uint64_t> _cells ;
+
+		/// @brief row_i -= f * row_r on the columns [first, _nb_cols), the inner kernel of the elimination
+		void subtract_row(const std::size_t i, const std::size_t r, const std::uint64_t f, const std::size_t first)
+		noexcept{
+			std::uint64_t* __restrict dst = _cells.data() + i*_nb_cols ;
+			const std::uint64_t* __restrict src = _cells.data() + r*_nb_cols ;
+			const Field field = _field ;
+			for(std::size_t k = first; k < _nb_cols; ++k) dst[k] = field.sub(dst[k], field.mul(f, src[k])) ;
+		}
+
+	public :
+
+	/*------------------- CONSTRUCT0R ---------------------*/
+
+		/// @brief null matrix
+		/// @param field the field of the residues
+		/// @param nb_rows number of rows
+		/// @param nb_cols number of columns
+		Matrix(const Field& field, const std::size_t nb_rows, const std::size_t nb_cols)
+		: _field(field), _nb_rows(nb_rows), _nb_cols(nb_cols), _cells(nb_rows * nb_cols, 0) {}
+
+		/// @brief residues of a matrix of ratios, with optionally one more column (e.g. a right-hand side)
+		/// @param field the field of the residues
+		/// @param A the matrix, one vector per row
+		/// @param b the extra column, ignored if empty
+		/// @param ok set to false if a denominator is a multiple of the prime
+		template<class T, class OverflowPolicy>
+		Matrix(const Field& field, const std::vector<std::vector<Ratio<T, OverflowPolicy>>>& A, const std::vector<Ratio<T, OverflowPolicy>>& b, bool& ok)
+		: Matrix(field, A.size(), (A.empty() ? 0 : A[0].size()) + (b.empty() ? 0 : 1)) {
+			ok = true ;
+			for(std::size_t i = 0; i < _nb_rows; ++i){
+				for(std::size_t j = 0; j < A[i].size(); ++j) ok &= _field.from_ratio(A[i][j], at(i, j)) ;
+				if(!b.empty()) ok &= _field.from_ratio(b[i], at(i, _nb_cols - 1)) ;
+			}
+		}
+
+
+	/*------------------- METHODES ---------------------*/
+
+		const Field& field() const noexcept{ return _field ; }
+		std::size_t nb_rows() const noexcept{ return _nb_rows ; }
+		std::size_t nb_cols() const noexcept{ return _nb_cols ; }
+
+		std::uint64_t& at(const std::size_t i, const std::size_t j) noexcept{ return _cells[i*_nb_cols + j] ; }
+		std::uint64_t at(const std::size_t i, const std::size_t j) const noexcept{ return _cells[i*_nb_cols + j] ; }
+
+		/// @brief gaussian elimination of the first nb_rows columns, in place : the matrix becomes upper triangular on these columns
+		/// @return the determinant of the square block of these columns (Montgomery form), zero if it is singular
+		std::uint64_t eliminate()
+		noexcept{
+			const std::size_t n = _nb_rows ;
+			assert( (_nb_cols >= n) && "error: not enough columns to eliminate");
+			std::uint64_t det = _field.one() ;
+			for(std::size_t j = 0; j < n; ++j){
+				std::size_t r = j ;
+				while(r < n && at(r, j) == 0) ++r ;
+				if(r == n) return 0 ;
+				if(r != j){
+					std::swap_ranges(_cells.begin() + r*_nb_cols, _cells.begin() + (r+1)*_nb_cols, _cells.begin() + j*_nb_cols) ;
+					det = _field.neg(det) ;
+				}
+				det = _field.mul(det, at(j, j)) ;
+				const std::uint64_t inv = _field.inverse(at(j, j)) ;
+				for(std::size_t i = j + 1; i < n; ++i){
+					if(at(i, j) == 0) continue ;
+					subtract_row(i, j, _field.mul(at(i, j), inv), j) ;
+				}
+			}
+			return det ;
+		}
+
+		/// @brief determinant of a square matrix (Montgomery form), the matrix is left triangular
+		std::uint64_t determinant()
+		noexcept{
+			assert( (_nb_rows == _nb_cols) && "error: the matrix must be square");
+			return eliminate() ;
+		}
+
+		/// @brief solve the square system stored with its right-hand side as the last column
+		/// @param x the solution (Montgomery form)
+		/// @return false if the system is singular modulo the prime
+		bool solve(std::vector<std::uint64_t>& x)
+		{
+			const std::size_t n = _nb_rows ;
+			assert( (_nb_cols == n + 1) && "error: the matrix must be [A | b] with A square");
+			if(eliminate() == 0) return false ;
+			x.assign(n, 0) ;
+			for(std::size_t i = n; i > 0; --i){
+				std::uint64_t s = at(i-1, n) ;
+				for(std::size_t k = i; k < n; ++k) s = _field.sub(s, _field.mul(at(i-1, k), x[k])) ;
+				x[i-1] = _field.mul(s, _field.inverse(at(i-1, i-1))) ;
+			}
+			return true ;
+		}
+	};
+
+
+/*------------------- RECONSTRUCTION ---------------------*/
+
+	/// @class Reconstruction
+	/// @brief residues of one ratio modulo several primes, combined by the chinese remainder theorem,
+	/// and the ratio recovered from them by rational reconstruction (extended Euclid stopped at half the size of the modulus)
+	class Reconstruction {
+
+	public :
+		/// @brief maximal number of primes, enough to recover a ratio of 128 bits integers and check its stability
+		static constexpr std::size_t max_primes = (64 * detail::Natural::nb_words) / 63 ;
+
+	private :
+		/// @brief product of the primes
+		detail::Natural _modulus ;
+		/// @brief the residue modulo _modulus, in [0, _modulus)
+		detail::Natural _value ;
+		/// @brief number of primes
+		std::size_t _nb_primes ;
+
+	public :
+
+	/*------------------- CONSTRUCT0R ---------------------*/
+
+		Reconstruction()
+		noexcept : _modulus(1), _value(0), _nb_primes(0) {}
+
+
+	/*------------------- METHODES ---------------------*/
+
+		/// @brief number of primes combined so far
+		std::size_t nb_primes() const noexcept{ return _nb_primes ; }
+
+		/// @brief true if another prime can be combined
+		bool full() const noexcept{ return _nb_primes >= max_primes ; }
+
+		/// @brief combine the residue x modulo a new prime
+		/// @param field the field of the prime, coprime with the previous ones
+		/// @param x the residue (Montgomery form)
+		void add(const Field& field, const std::uint64_t x)
+		noexcept{
+			assert( !full() && "error: too many primes");
+			// value += modulus * ((x - value) / modulus mod p)
+			const std::uint64_t value = field.from_unsigned(_value.mod(field.modulus())) ;
+			const std::uint64_t modulus = field.from_unsigned(_modulus.mod(field.modulus())) ;
+			const std::uint64_t t = field.to_unsigned(field.mul(field.sub(x, value), field.inverse(modulus))) ;
+			_value += _modulus * t ;
+			_modulus = _modulus * field.modulus() ;
+			++_nb_primes ;
+		}
+
+		/// @brief the ratio n/d with |n|, d < sqrt(modulus/2) congruent to the residue, if any
+		/// @param r the ratio, irreducible
+		/// @return false if there is no such ratio, or if it does not fit in U
+		template<class U>
+		bool reconstruct(Ratio<U>& r) const
+		noexcept{
+			// bound = 2^k with 2*bound^2 <= modulus
+			const std::size_t length = _modulus.bit_length() ;
+			if(length < 2) return false ;
+			const std::size_t k = (length - 2) / 2 ;
+
+			// extended Euclid on (modulus, value) : r_i = t_i * value mod modulus, with |t_i| growing and the signs of t_i alternating
+			detail::Natural r0 = _modulus, r1 = _value ;
+			detail::Natural t0(0), t1(1) ;
+			bool negative = false ;
+			while(r1.bit_length() > k){
+				// r0 mod r1 by shifts and subtractions, the quotients being small most of the time
+				const std::size_t shift = r0.bit_length() - r1.bit_length() ;
+				for(std::size_t s = shift + 1; s > 0; --s){
+					const detail::Natural shifted = r1 << (s - 1) ;
+					if(shifted <= r0){
+						r0 -= shifted ;
+						t0 += t1 << (s - 1) ;
+					}
+				}
+				std::swap(r0, r1) ;
+				std::swap(t0, t1) ;
+				negative = !negative ;
+			}
+			if(t1.bit_length() > k) return false ;
+
+			constexpr std::size_t digits = static_cast<std::size_t>(std::numeric_limits<U>::digits) ;
+			if(r1.bit_length() > digits || t1.bit_length() > digits) return false ;
+			const ratio_uint128 num = r1.low128(), den = t1.low128() ;
+			ratio_uint128 a = num, b = den ;
+			while(b != 0){
+				const ratio_uint128 c = a % b ;
+				a = b ;
+				b = c ;
+			}
+			if(a != 1) return false ;
+			r = Ratio<U>(negative ? -static_cast<U>(num) : static_cast<U>(num), static_cast<U>(den), reduced_tag) ;
+			return true ;
+		}
+	};
+
+
+/*------------------- ALGORITHMS ---------------------*/
+
+	namespace detail {
+
+		/// @brief integer type of the result : Out, or T if Out is void
+		template<class Out, class T>
+		using result_t = typename std::conditional<std::is_void<Out>::value, T, Out>::type ;
+
+		/// @brief run f(k) for k in [0, count), on up to nb_threads threads
+		template<class Function>
+		void parallel_for(const std::size_t count, const std::size_t nb_threads, Function f)
+		{
+			if(nb_threads <= 1 || count <= 1){
+				for(std::size_t k = 0; k < count; ++k) f(k) ;
+				return ;
+			}
+			std::vector<std::thread> threads ;
+			const std::size_t nb = std::min(nb_threads, count) ;
+			for(std::size_t t = 0; t < nb; ++t){
+				threads.emplace_back([t, nb, count, &f](){
+					for(std::size_t k = t; k < count; k += nb) f(k) ;
+				}) ;
+			}
+			for(std::thread& thread : threads) thread.join() ;
+		}
+
+		/// @brief multi-modular driver : solve the problem modulo batches of nb_threads primes in parallel, combine the residues,
+		/// and stop when every reconstructed ratio is the same as with one prime less
+		/// @param nb_values number of ratios of the result
+		/// @param nb_threads number of threads
+		/// @param residues residues(field, x) fills x with the nb_values residues, returns false for a prime where the problem degenerates
+		/// @param result the ratios
+		/// @return false if the problem degenerates modulo the first primes (e.g. singular matrix)
+		template<class U, class Residues>
+		bool multi_modular(const std::size_t nb_values, const std::size_t nb_threads, Residues residues, std::vector<Ratio<U>>& result)
+		{
+			const std::size_t batch = std::max<std::size_t>(nb_threads, 1) ;
+			std::vector<Reconstruction> reconstructions(nb_values) ;
+			std::vector<bool> stable(nb_values, false) ;
+			result.assign(nb_values, Ratio<U>()) ;
+			if(nb_values == 0) return true ;
+			std::size_t next = 0, nb_degenerate = 0 ;
+
+			while(true){
+				// residues modulo the next primes, one prime per thread
+				std::vector<Field> fields ;
+				for(std::size_t k = 0; k < batch; ++k) fields.emplace_back(prime(next + k)) ;
+				next += batch ;
+				std::vector<std::vector<std::uint64_t>> x(batch) ;
+				std::vector<char> ok(batch, 0) ;
+				parallel_for(batch, nb_threads, [&](const std::size_t k){ ok[k] = residues(fields[k], x[k]) ? 1 : 0 ; }) ;
+
+				std::vector<std::size_t> good ;
+				for(std::size_t k = 0; k < batch; ++k){
+					if(ok[k]) good.push_back(k) ;
+				}
+				// the problem degenerates modulo a prime p with probability ~1/p, unless it does over the rationals
+				nb_degenerate += batch - good.size() ;
+				if(reconstructions[0].nb_primes() == 0 && nb_degenerate >= 2) return false ;
+				if(good.size() + reconstructions[0].nb_primes() > Reconstruction::max_primes){
+					good.resize(Reconstruction::max_primes - reconstructions[0].nb_primes()) ;
+				}
+
+				// combination and reconstruction, one slice of the values per thread
+				parallel_for(nb_values, nb_threads, [&](const std::size_t i){
+					for(const std::size_t k : good){
+						reconstructions[i].add(fields[k], x[k][i]) ;
+						Ratio<U> r ;
+						const bool found = reconstructions[i].reconstruct(r) ;
+						stable[i] = found && reconstructions[i].nb_primes() > 1 && r.get_numerator() == result[i].get_numerator() && r.get_denominator() == result[i].get_denominator() ;
+						result[i] = found ? r : Ratio<U>(0, 0, reduced_tag) ;
+					}
+				}) ;
+
+				if(std::all_of(stable.begin(), stable.end(), [](const bool s){ return s ; })) return true ;
+				if(reconstructions[0].full()){
+					throw std::overflow_error("modular: the result does not fit in the integer type") ;
+				}
+			}
+		}
+
+	}
+
+	/// @brief exact determinant of a square matrix of ratios
+	/// @tparam Out integer type of the result (default : T), e.g. ratio_int128 for a result wider than the input
+	/// @param A the matrix, one vector per row
+	/// @param nb_threads number of primes processed in parallel
+	/// @return the determinant, throws std::overflow_error if it does not fit in Out
+	template<class Out = void, class T, class OverflowPolicy>
+	Ratio<detail::result_t<Out, T>> determinant(const std::vector<std::vector<Ratio<T, OverflowPolicy>>>& A, const std::size_t nb_threads = 1)
+	{
+		using U = detail::result_t<Out, T> ;
+		std::vector<Ratio<U>> result ;
+		detail::multi_modular<U>(1, nb_threads, [&A](const Field& field, std::vector<std::uint64_t>& x){
+			bool ok = true ;
+			Matrix m(field, A, std::vector<Ratio<T, OverflowPolicy>>(), ok) ;
+			x.assign(1, m.determinant()) ;
+			return ok ;
+		}, result) ;
+		return result[0] ;
+	}
+
+	/// @brief exact solution of the square system A.x = b
+	/// @tparam Out integer type of the solution (default : T)
+	/// @param A the matrix, one vector per row
+	/// @param b the right-hand side
+	/// @param x the solution
+	/// @param nb_threads number of primes processed in parallel
+	/// @return false if A is singular ; throws std::overflow_error if the solution does not fit in Out
+	template<class Out = void, class T, class OverflowPolicy>
+	bool solve(const std::vector<std::vector<Ratio<T, OverflowPolicy>>>& A, const std::vector<Ratio<T, OverflowPolicy>>& b, std::vector<Ratio<detail::result_t<Out, T>>>& x, const std::size_t nb_threads = 1)
+	{
+		using U = detail::result_t<Out, T> ;
+		assert( (A.size() == b.size()) && "error: one right-hand side per row");
+		return detail::multi_modular<U>(A.size(), nb_threads, [&A, &b](const Field& field, std::vector<std::uint64_t>& residues){
+			bool ok = true ;
+			Matrix m(field, A, b, ok) ;
+			return ok && m.solve(residues) ;
+		}, x) ;
+	}
+
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+
+
+#if defined(__SIZEOF_INT128__)
+/// @brief 128 bits signed integer, used as the wide type of 64 bits ratios
+__extension__ typedef __int128 ratio_int128 ;
+/// @brief 128 bits unsigned integer
+__extension__ typedef unsigned __int128 ratio_uint128 ;
+#endif
+
+#if defined(__SIZEOF_INT128__) && (defined(__GLIBCXX_TYPE_INT_N_0) || defined(_LIBCPP_VERSION))
+/// @brief the type traits of the standard library (std::make_unsigned, std::numeric_limits...) know the 128 bits integers,
+/// which libstdc++ does not in strict ISO mode (-std=c++17) : Ratio<ratio_int128> needs them
+#define RATIO_HAS_INT128_TRAITS
+#endif
+
+
+/*------------------- WIDER TYPE ---------------------*/
+
+/// @brief integer type with at least twice the bits of T, used to compute intermediate results without overflow
+/// @tparam T can be : int, long int, long long int and their unsigned versions (the 128 bits integers have no wider type)
+template<class T>
+struct wider {};
+
+template<> struct wider<short> { using type = int; };
+template<> struct wider<int> { using type = long long int; };
+template<> struct wider<unsigned short> { using type = unsigned int; };
+template<> struct wider<unsigned int> { using type = unsigned long long int; };
+#if defined(__SIZEOF_INT128__)
+template<> struct wider<long int> { using type = typename std::conditional<sizeof(long int) == 8, ratio_int128, long long int>::type; };
+template<> struct wider<long long int> { using type = ratio_int128; };
+template<> struct wider<unsigned long int> { using type = typename std::conditional<sizeof(long int) == 8, ratio_uint128, unsigned long long int>::type; };
+template<> struct wider<unsigned long long int> { using type = ratio_uint128; };
+#endif
+
+/// @brief shortcut for wider<T>::type
+template<class T>
+using wider_t = typename wider<T>::type;
+
+/// @brief true if wider<T> defines a wider integer type
+template<class T, class = void>
+struct has_wider : std::false_type {};
+
+template<class T>
+struct has_wider<T, std::void_t<typename wider<T>::type>> : std::true_type {};
+
+
+
+/*------------------- OVERFLOW POLICIES ---------------------*/
+
+/// @brief overflow policies of Ratio, selected at compile time by its second template parameter
+namespace overflow {
+
+	/// @brief checked integer primitives shared by the policies which detect overflow
+	namespace detail {
+
+		/// @brief a + b, set overflow to true if the result is not representable
+		template<class T>
+		constexpr T checked_add(const T a, const T b, bool& overflow)
+		noexcept{
+		#if defined(__GNUC__) || defined(__clang__)
+			T result = 0 ;
+			overflow |= __builtin_add_overflow(a, b, &result) ;
+			return result ;
+		#else
+			if((b > 0 && a > std::numeric_limits<T>::max() - b)
+			|| (b < 0 && a < std::numeric_limits<T>::min() - b)){
+				overflow = true ;
+				return 0 ;
+			}
+			return a + b ;
+		#endif
+		}
+
+		/// @brief a - b, set overflow to true if the result is not representable
+		template<class T>
+		constexpr T checked_sub(const T a, const T b, bool& overflow)
+		noexcept{
+		#if defined(__GNUC__) || defined(__clang__)
+			T result = 0 ;
+			overflow |= __builtin_sub_overflow(a, b, &result) ;
+			return result ;
+		#else
+			if((b < 0 && a > std::numeric_limits<T>::max() + b)
+			|| (b > 0 && a < std::numeric_limits<T>::min() + b)){
+				overflow = true ;
+				return 0 ;
+			}
+			return a - b ;
+		#endif
+		}
+
+		/// @brief a * b, set overflow to true if the result is not representable
+		template<class T>
+		constexpr T checked_mul(const T a, const T b, bool& overflow)
+		noexcept{
+		#if defined(__GNUC__) || defined(__clang__)
+			T result = 0 ;
+			overflow |= __builtin_mul_overflow(a, b, &result) ;
+			return result ;
+		#else
+			if(a == 0 || b == 0) return 0 ;
+			const T max = std::numeric_limits<T>::max() ;
+			const T min = std::numeric_limits<T>::min() ;
+			if((a > 0 && b > 0 && a > max / b)
+			|| (a > 0 && b < 0 && b < min / a)
+			|| (a < 0 && b > 0 && a < min / b)
+			|| (a < 0 && b < 0 && a < max / b)){
+				overflow = true ;
+				return 0 ;
+			}
+			return a * b ;
+		#endif
+		}
+
+		/// @brief primitives of the policies which detect overflow in the type T itself
+		struct Checking {
+			static constexpr bool detects_overflow = true ;
+
+			template<class T>
+			using wide_type = T ;
+
+			template<class T>
+			static constexpr T add(const T a, const T b, bool& overflow) noexcept{ return checked_add(a, b, overflow) ; }
+
+			template<class T>
+			static constexpr T sub(const T a, const T b, bool& overflow) noexcept{ return checked_sub(a, b, overflow) ; }
+
+			template<class T>
+			static constexpr T mul(const T a, const T b, bool& overflow) noexcept{ return checked_mul(a, b, overflow) ; }
+		};
+
+	}
+
+
+	/// @brief silent two's complement wraparound, the historical behavior of Ratio (default policy)
+	struct Wrap {
+		static constexpr bool is_noexcept = true ;
+		static constexpr bool detects_overflow = false ;
+
+		template<class T>
+		using wide_type = T ;
+
+		template<class T>
+		static constexpr T add(const T a, const T b, bool&)
+		noexcept{
+			using U = typename std::make_unsigned<T>::type ;
+			return static_cast<T>(static_cast<U>(a) + static_cast<U>(b)) ;
+		}
+
+		template<class T>
+		static constexpr T sub(const T a, const T b, bool&)
+		noexcept{
+			using U = typename std::make_unsigned<T>::type ;
+			return static_cast<T>(static_cast<U>(a) - static_cast<U>(b)) ;
+		}
+
+		template<class T>
+		static constexpr T mul(const T a, const T b, bool&)
+		noexcept{
+			using U = typename std::make_unsigned<T>::type ;
+			return static_cast<T>(static_cast<U>(a) * static_cast<U>(b)) ;
+		}
+
+		/// @brief never called, Wrap does not detect overflow
+		template<class R>
+		static constexpr R on_overflow() noexcept{ return R::inf() ; }
+	};
+
+	/// @brief throw std::overflow_error as soon as an operation overflows
+	struct Checked : detail::Checking {
+		static constexpr bool is_noexcept = false ;
+
+		template<class R>
+		static R on_overflow(){ throw std::overflow_error("Ratio: integer overflow") ; }
+	};
+
+	/// @brief an overflowing operation gives inf()
+	struct Saturate : detail::Checking {
+		static constexpr bool is_noexcept = true ;
+
+		template<class R>
+		static constexpr R on_overflow() noexcept{ return R::inf() ; }
+	};
+
+	/// @brief compute the intermediate results in wider_t<T>, reduce them, then come back to T.
+	/// Throw std::overflow_error if even the reduced result does not fit in T.
+	struct Promote {
+		static constexpr bool is_noexcept = false ;
+		static constexpr bool detects_overflow = true ;
+
+		template<class T>
+		using wide_type = wider_t<T> ;
+
+		template<class T>
+		static constexpr T add(const T a, const T b, bool& overflow) noexcept{ return detail::checked_add(a, b, overflow) ; }
+
+		template<class T>
+		static constexpr T sub(const T a, const T b, bool& overflow) noexcept{ return detail::checked_sub(a, b, overflow) ; }
+
+		template<class T>
+		static constexpr T mul(const T a, const T b, bool& overflow) noexcept{ return detail::checked_mul(a, b, overflow) ; }
+
+		template<class R>
+		static R on_overflow(){ throw std::overflow_error("Ratio: reduced result does not fit in the integer type") ; }
+	};
+
+}
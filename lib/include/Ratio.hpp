@@ -5,13 +5,144 @@
 #include <cmath>
 #include <fstream>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <charconv>
+#include <system_error>
+#include <type_traits>
 
+#include "OverflowPolicy.hpp"
+
+
+/// @brief tag selecting the Ratio constructor which trusts its arguments to be already in irreducible form
+struct ReducedTag {
+	explicit ReducedTag() = default ;
+};
+
+/// @brief the numerator and the denominator given to the constructor are coprime, and the denominator is positive
+inline constexpr ReducedTag reduced_tag{} ;
+
+
+#ifdef RATIO_COUNT_GCD
+/// @brief number of gcds computed by Ratio in the current thread, to measure the cost of the operators (benchmarks only)
+inline thread_local unsigned long long ratio_gcd_count = 0 ;
+#endif
+
+/*------------------- INTEGER KERNELS ---------------------*/
+
+/// @brief absolute value of an integer in the unsigned type of the same width, valid even for the minimum of a signed type
+template<class I>
+constexpr typename std::make_unsigned<I>::type ratio_magnitude(const I x)
+noexcept{
+	using U = typename std::make_unsigned<I>::type ;
+	if constexpr (std::is_signed<I>::value){
+		if(x < static_cast<I>(0)) return static_cast<U>(static_cast<U>(0) - static_cast<U>(x)) ;
+	}
+	return static_cast<U>(x) ;
+}
+
+/// @brief number of trailing zero bits of x, not null (up to 128 bits)
+template<class U>
+constexpr int count_trailing_zeros(const U x)
+noexcept{
+#if defined(__GNUC__) || defined(__clang__)
+	if constexpr (std::numeric_limits<U>::digits <= 64) return __builtin_ctzll(static_cast<unsigned long long>(x)) ;
+	else {
+		const unsigned long long low = static_cast<unsigned long long>(x) ;
+		return (low != 0) ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<unsigned long long>(x >> 64)) ;
+	}
+#else
+	int n = 0 ;
+	for(U y = x; (y & 1) == 0; y >>= 1) ++n ;
+	return n ;
+#endif
+}
+
+/// @brief binary gcd (Stein) of two unsigned integers : shifts and subtractions only.
+/// On 128 bits, it runs until both numbers fit in 64 bits, where std::gcd and the hardware take over.
+template<class U>
+constexpr U binary_gcd(U a, U b)
+noexcept{
+	static_assert(!std::is_signed<U>::value, "the binary gcd works on magnitudes");
+	constexpr bool is_wide = std::numeric_limits<U>::digits > 64 ;
+	if constexpr (is_wide){
+		if(((a | b) >> 64) == 0) return static_cast<U>(std::gcd(static_cast<unsigned long long>(a), static_cast<unsigned long long>(b))) ;
+	}
+	if(a == 0) return b ;
+	if(b == 0) return a ;
+	const int shift = count_trailing_zeros(static_cast<U>(a | b)) ;
+	a >>= count_trailing_zeros(a) ;
+	b >>= count_trailing_zeros(b) ;
+	while(true){
+		// a and b are odd : replace the largest by the difference, which is even, then remove its factors 2
+		if constexpr (is_wide){
+			if(((a | b) >> 64) == 0) return static_cast<U>(std::gcd(static_cast<unsigned long long>(a), static_cast<unsigned long long>(b))) << shift ;
+		}
+		if(a > b){
+			const U tmp = a ;
+			a = b ;
+			b = tmp ;
+		}
+		b -= a ;
+		if(b == 0) return a << shift ;
+		b >>= count_trailing_zeros(b) ;
+	}
+}
+
+/// @brief gcd of the components of a ratio, counted in ratio_gcd_count when RATIO_COUNT_GCD is defined.
+/// The 128 bits integers use the binary gcd : their divisions are calls to a software routine.
+template<class W>
+constexpr W ratio_gcd(const W a, const W b)
+noexcept{
+#ifdef RATIO_COUNT_GCD
+	++ratio_gcd_count ;
+#endif
+	if constexpr (std::numeric_limits<W>::digits > 64) return static_cast<W>(binary_gcd(ratio_magnitude(a), ratio_magnitude(b))) ;
+	else return std::gcd(a, b) ;
+}
+
+/// @brief decimal text of an integer, like std::to_chars, for every width up to 128 bits
+/// @param first start of the buffer
+/// @param last end of the buffer
+/// @param x the integer
+/// @return ptr : end of the text ; ec : std::errc() on success, std::errc::value_too_large (ptr == last) if the buffer is too small
+template<class I>
+std::to_chars_result ratio_to_chars(char* first, char* last, const I x)
+noexcept{
+	using U = typename std::make_unsigned<I>::type ;
+	char digits[std::numeric_limits<U>::digits10 + 1] ;
+	std::size_t n = 0 ;
+	U y = ratio_magnitude(x) ;
+	if constexpr (std::numeric_limits<U>::digits > 64){
+		// one 128 bits division per block of 19 digits, the digits themselves with 64 bits divisions
+		constexpr unsigned long long block = 10000000000000000000ull ;
+		while(y > std::numeric_limits<unsigned long long>::max()){
+			unsigned long long part = static_cast<unsigned long long>(y % block) ;
+			y /= block ;
+			for(int i = 0; i < 19; ++i, part /= 10) digits[n++] = static_cast<char>('0' + part % 10) ;
+		}
+	}
+	unsigned long long rest = static_cast<unsigned long long>(y) ;
+	do {
+		digits[n++] = static_cast<char>('0' + rest % 10) ;
+		rest /= 10 ;
+	} while(rest != 0) ;
+
+	bool negative = false ;
+	if constexpr (std::is_signed<I>::value) negative = x < static_cast<I>(0) ;
+	if(static_cast<std::size_t>(last - first) < n + (negative ? 1 : 0)) return {last, std::errc::value_too_large} ;
+	if(negative) *first++ = '-' ;
+	for(std::size_t i = 0; i < n; ++i) first[i] = digits[n - 1 - i] ;
+	return {first + n, std::errc()} ;
+}
 
 
 /// @class Ratio 
 /// @brief class defining a ratio to represent a real number by a quotient of 2 integers
-/// @tparam T can be : int, long int
-template<class T>
+/// @tparam T can be : int, long int, long long int, ratio_int128 (128 bits, exact without bignum, if RATIO_HAS_INT128_TRAITS is defined) or an unsigned integer type (no sign handling)
+/// @tparam OverflowPolicy behavior when an operation overflows : overflow::Wrap (default), overflow::Checked, overflow::Saturate or overflow::Promote
+template<class T, class OverflowPolicy = overflow::Wrap>
 class Ratio {
 
 private : 
@@ -20,6 +151,208 @@ private :
     /// @brief denominator of the ratio 
     T _denominator;
 
+	/// @brief integer type in which the operators compute before reduction (T, except for overflow::Promote)
+	using wide_type = typename OverflowPolicy::template wide_type<T> ;
+
+	/// @brief convert a component of the ratio to the wide type
+	static constexpr wide_type wide(const T x)
+	noexcept{
+		return static_cast<wide_type>(x) ;
+	}
+
+	/// @brief build the result of an operation computed in the wide type, according to the overflow policy
+	/// @param num numerator computed by the operation
+	/// @param den denominator computed by the operation
+	/// @param overflow true if one of the primitive operations overflowed
+	/// @return the ratio num/den in irreducible form (one gcd), or the policy's answer to the overflow
+	static constexpr Ratio from_wide(wide_type num, wide_type den, const bool overflow)
+	noexcept(OverflowPolicy::is_noexcept){
+		if constexpr (OverflowPolicy::detects_overflow){
+			if(overflow) return OverflowPolicy::template on_overflow<Ratio>() ;
+		}
+		if constexpr (!std::is_same<wide_type, T>::value){
+			const wide_type pgcd = ratio_gcd(num, den) ; 
+			if(pgcd != 0){
+				num = num/pgcd ; 
+				den = den/pgcd ; 
+			}
+			if constexpr (std::is_signed<wide_type>::value){
+				if(den < 0){
+					num = -num ; 
+					den = -den ; 
+				}
+			}
+			if(!fits(num) || !fits(den)){
+				return OverflowPolicy::template on_overflow<Ratio>() ;
+			}
+			return Ratio(static_cast<T>(num), static_cast<T>(den), reduced_tag) ;
+		}
+		else return Ratio(num, den) ;
+	}
+
+	/// @brief build the result of an operation known to be irreducible already (integer fast paths), without gcd
+	/// @param num numerator computed by the operation, carrying the sign
+	/// @param den denominator computed by the operation, positive and coprime with num
+	/// @param overflow true if one of the primitive operations overflowed
+	/// @return the ratio num/den, or the policy's answer to the overflow
+	static constexpr Ratio from_wide_reduced(const wide_type num, const wide_type den, const bool overflow)
+	noexcept(OverflowPolicy::is_noexcept){
+		if constexpr (OverflowPolicy::detects_overflow){
+			if(overflow) return OverflowPolicy::template on_overflow<Ratio>() ;
+		}
+		if constexpr (!std::is_same<wide_type, T>::value){
+			if(!fits(num) || !fits(den)){
+				return OverflowPolicy::template on_overflow<Ratio>() ;
+			}
+		}
+		return Ratio(static_cast<T>(num), static_cast<T>(den), reduced_tag) ;
+	}
+
+	/// @brief unsigned type holding the magnitude of the components
+	using magnitude_type = typename std::make_unsigned<T>::type ;
+
+	/// @brief absolute value of a component, valid even for the minimum of T
+	static constexpr magnitude_type magnitude(const T x)
+	noexcept{
+		return ratio_magnitude(x) ;
+	}
+
+	/// @brief sign of a component, always false for an unsigned T so that the sign handling compiles away
+	static constexpr bool is_negative(const T x)
+	noexcept{
+		if constexpr (std::is_signed<T>::value) return x < static_cast<T>(0) ;
+		else {
+			static_cast<void>(x) ;
+			return false ;
+		}
+	}
+
+	/// @brief check if an integer of the wide type W is in the range of T
+	template<class W>
+	static constexpr bool fits(const W x)
+	noexcept{
+		if constexpr (std::is_signed<W>::value) return x <= static_cast<W>(std::numeric_limits<T>::max()) && x >= static_cast<W>(std::numeric_limits<T>::min()) ;
+		else return x <= static_cast<W>(std::numeric_limits<T>::max()) ;
+	}
+
+	/// @brief x^n by squaring, with the primitives of the overflow policy
+	static constexpr T power(T x, unsigned int n, bool& overflow)
+	noexcept{
+		T result = 1 ;
+		while(n != 0){
+			if((n & 1u) != 0) result = OverflowPolicy::mul(result, x, overflow) ;
+			n >>= 1 ;
+			if(n != 0) x = OverflowPolicy::mul(x, x, overflow) ;
+		}
+		return result ;
+	}
+
+	/// @brief compare n1/d1 and n2/d2 (a null denominator meaning infinity) by the terms of their continued fractions,
+	/// without any product : used when T has no wider type to compute the cross products
+	/// @return a negative number if n1/d1 < n2/d2, 0 if they are equal, a positive number otherwise
+	static constexpr int compare_magnitudes(magnitude_type n1, magnitude_type d1, magnitude_type n2, magnitude_type d2)
+	noexcept{
+		int sign = 1 ;
+		while(true){
+			if(d1 == 0 || d2 == 0) return sign * (static_cast<int>(d1 == 0) - static_cast<int>(d2 == 0)) ;
+			const magnitude_type q1 = n1 / d1, q2 = n2 / d2 ;
+			if(q1 != q2) return (q1 < q2) ? -sign : sign ;
+			// same integer part : compare the fractional parts r1/d1 and r2/d2, that is d2/r2 and d1/r1
+			const magnitude_type r1 = n1 - q1*d1, r2 = n2 - q2*d2 ;
+			n1 = d1 ; d1 = r1 ;
+			n2 = d2 ; d2 = r2 ;
+			sign = -sign ;
+		}
+	}
+
+	/// @brief check if a component can be converted to F without rounding
+	template<class F>
+	static constexpr bool is_exact_in(const T x)
+	noexcept{
+		if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<F>::digits) return true ;
+		else return magnitude(x) <= (static_cast<magnitude_type>(1) << std::numeric_limits<F>::digits) ;
+	}
+
+	/// @brief correctly rounded (to nearest, ties to even) quotient n/d computed with integer operations only
+	/// @param n magnitude of the numerator
+	/// @param d magnitude of the denominator, not null
+	/// @param negative sign of the result
+	/// @return the floating point number nearest to n/d
+	template<class F>
+	static F exact_division(const magnitude_type n, const magnitude_type d, const bool negative)
+	noexcept{
+		constexpr int precision = std::numeric_limits<F>::digits ; 
+		static_assert(precision < 64, "the mantissa has to fit in 64 bits");
+
+		// number of significant bits of x
+		auto bit_length = [](magnitude_type x){ int length = 0 ; while(x != 0){ ++length ; x >>= 1 ; } return length ; } ;
+
+		// integer part, then the bits after the point one by one, until precision+1 bits (the last one is the rounding bit)
+		magnitude_type q = n / d ; 
+		magnitude_type r = n % d ; 
+		std::uint64_t mantissa ; 
+		int exponent = 0 ; 
+		bool sticky ; 
+		const int q_length = bit_length(q) ; 
+		if(q_length > precision + 1){
+			const int shift = q_length - (precision + 1) ; 
+			sticky = (q & ((static_cast<magnitude_type>(1) << shift) - 1)) != 0 || r != 0 ; 
+			mantissa = static_cast<std::uint64_t>(q >> shift) ; 
+			exponent = shift ; 
+		}
+		else {
+			mantissa = static_cast<std::uint64_t>(q) ; 
+			while(mantissa < (std::uint64_t(1) << precision)){
+				// 2r >= d, written to avoid overflowing 2r
+				const bool bit = r >= d - r ; 
+				r = bit ? r - (d - r) : r + r ; 
+				mantissa = (mantissa << 1) | static_cast<std::uint64_t>(bit) ; 
+				--exponent ; 
+			}
+			sticky = r != 0 ; 
+		}
+
+		// below the normal range the last bit is worth denorm_min : the bits under it are dropped too, with a single rounding
+		const int drop = std::max(1, std::numeric_limits<F>::min_exponent - precision - exponent) ; 
+		if(drop > precision + 1) return negative ? -static_cast<F>(0) : static_cast<F>(0) ; 
+		sticky = sticky || (mantissa & ((std::uint64_t(1) << (drop - 1)) - 1)) != 0 ; 
+		const bool half = ((mantissa >> (drop - 1)) & 1) != 0 ; 
+		mantissa >>= drop ; 
+		exponent += drop ; 
+		if(half && (sticky || (mantissa & 1) != 0)) ++mantissa ; 
+
+		const F result = std::ldexp(static_cast<F>(mantissa), exponent) ; 
+		return negative ? -result : result ; 
+	}
+
+	/// @brief correctly rounded conversion to the floating point type F
+	template<class F>
+	constexpr F to_floating_point() const
+	noexcept{
+		if(is_exact_in<F>(this->_numerator) && is_exact_in<F>(this->_denominator)){
+			// both parts are exact in F, so the division is correctly rounded by the hardware
+			return static_cast<F>(this->_numerator) / static_cast<F>(this->_denominator) ; 
+		}
+		if(this->_denominator == 0) return is_negative(this->_numerator) ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity() ; 
+		return exact_division<F>(magnitude(this->_numerator), magnitude(this->_denominator), is_negative(this->_numerator) != is_negative(this->_denominator)) ; 
+	}
+
+	/// @brief batch conversion : one hardware division per ratio, then exact fix-up of the ratios out of the fast path
+	template<class F>
+	static void to_floating_point(const Ratio* ratios, const std::size_t count, F* out)
+	noexcept{
+		for(std::size_t i = 0; i < count; ++i){
+			out[i] = static_cast<F>(ratios[i]._numerator) / static_cast<F>(ratios[i]._denominator) ; 
+		}
+		if constexpr (std::numeric_limits<T>::digits > std::numeric_limits<F>::digits){
+			for(std::size_t i = 0; i < count; ++i){
+				if(!is_exact_in<F>(ratios[i]._numerator) || !is_exact_in<F>(ratios[i]._denominator)){
+					out[i] = ratios[i].template to_floating_point<F>() ; 
+				}
+			}
+		}
+	}
+
 public :
 
 /*------------------- CONSTRUCT0R ---------------------*/
@@ -36,6 +369,14 @@ public :
 		this->set_minus() ;
 	}
 
+	/// @brief constructor from a numerator and a denominator already in irreducible form, no gcd is computed
+	/// @param num numerator of the ratio, carrying the sign
+	/// @param den denominator of the ratio, positive and coprime with num
+    constexpr Ratio(const T num, const T den, ReducedTag)
+	noexcept : _numerator(num), _denominator(den) {
+		static_assert(std::is_integral<T>::value, "Integral required.");
+	}
+
 	/// @brief copy-constructor
 	/// @param r source ratio to be copied
 	Ratio(const Ratio &r) = default;
@@ -48,14 +389,14 @@ public :
 	
 	/// @brief getter of the ratio numerator 
 	/// @return numerator of the current ratio
-	constexpr T get_numerator() 
+	constexpr T get_numerator() const
 	noexcept{
 		return this->_numerator ; 
 	} 
 	
 	/// @brief getter of the ratio denominator 
 	/// @return denominator of the current ratio
-	constexpr T get_denominator() 
+	constexpr T get_denominator() const
 	noexcept{
 		return this->_denominator ; 
 	}
@@ -81,94 +422,225 @@ public :
 
 /*------------------- OPERATOR ---------------------*/
 
-    /// @brief affectation operator
+    /// @brief affectation operator, defaulted so that Ratio is trivially copyable
     /// @param r ratio affetct to the calling ratio 
-    constexpr Ratio& operator=(const Ratio &r)
-	noexcept{
-		if(&r == this) return *this;
-		this->_denominator = r._denominator;
-		this->_numerator = r._numerator;
-		return *this;
+    Ratio& operator=(const Ratio &r) = default;
+
+	/// @brief add a ratio to the calling ratio, in place (one gcd, none if one of the ratios is an integer)
+    /// @param r ratio to add to the calling ratio 
+    /// @return the calling ratio, sum of itself and r
+    constexpr Ratio& operator+= (const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		if(r._denominator == static_cast<T>(1)) return *this += r._numerator ; 
+		bool overflow = false ; 
+		if(this->_denominator == static_cast<T>(1)){
+			// a + n/d = (a*d + n)/d, coprime with d like n
+			const wide_type num = OverflowPolicy::add(OverflowPolicy::mul(wide(this->_numerator), wide(r._denominator), overflow), wide(r._numerator), overflow) ; 
+			return *this = from_wide_reduced(num, wide(r._denominator), overflow) ; 
+		}
+		const wide_type num = OverflowPolicy::add(OverflowPolicy::mul(wide(this->_numerator), wide(r._denominator), overflow),
+		                                          OverflowPolicy::mul(wide(this->_denominator), wide(r._numerator), overflow), overflow) ; 
+		const wide_type den = OverflowPolicy::mul(wide(this->_denominator), wide(r._denominator), overflow) ; 
+		return *this = from_wide(num, den, overflow) ; 
+	}
+
+	/// @brief subtract a ratio to the calling ratio, in place (one gcd, none if one of the ratios is an integer)
+    /// @param r ratio to subtract to the calling ratio 
+    /// @return the calling ratio, difference of itself and r
+    constexpr Ratio& operator-= (const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		if(r._denominator == static_cast<T>(1)) return *this -= r._numerator ; 
+		bool overflow = false ; 
+		if(this->_denominator == static_cast<T>(1)){
+			// a - n/d = (a*d - n)/d, coprime with d like n
+			const wide_type num = OverflowPolicy::sub(OverflowPolicy::mul(wide(this->_numerator), wide(r._denominator), overflow), wide(r._numerator), overflow) ; 
+			return *this = from_wide_reduced(num, wide(r._denominator), overflow) ; 
+		}
+		const wide_type num = OverflowPolicy::sub(OverflowPolicy::mul(wide(this->_numerator), wide(r._denominator), overflow),
+		                                          OverflowPolicy::mul(wide(this->_denominator), wide(r._numerator), overflow), overflow) ; 
+		const wide_type den = OverflowPolicy::mul(wide(this->_denominator), wide(r._denominator), overflow) ; 
+		return *this = from_wide(num, den, overflow) ; 
+	}
+
+	/// @brief multiply the calling ratio by a ratio, in place (one gcd, none if both ratios are integers)
+    /// @param r ratio to multiply to the calling ratio 
+    /// @return the calling ratio, product of itself and r
+    constexpr Ratio& operator*= (const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		if(r._denominator == static_cast<T>(1)) return *this *= r._numerator ; 
+		if(this->_denominator == static_cast<T>(1)){
+			const T nb = this->_numerator ; 
+			*this = r ; 
+			return *this *= nb ; 
+		}
+		bool overflow = false ; 
+		const wide_type num = OverflowPolicy::mul(wide(this->_numerator), wide(r._numerator), overflow) ; 
+		const wide_type den = OverflowPolicy::mul(wide(this->_denominator), wide(r._denominator), overflow) ; 
+		return *this = from_wide(num, den, overflow) ; 
+	}
+
+	/// @brief divide the calling ratio by a ratio, in place (one gcd)
+    /// @param r ratio to divide to the calling ratio 
+    /// @return the calling ratio, quotient of itself and r
+    constexpr Ratio& operator/= (const Ratio& r){
+		assert( (this->_denominator != 0) && "error: the denominator is null");
+		assert( (r._numerator != 0) && "error: the denominator is null");
+		if(r._denominator == static_cast<T>(1)) return *this /= r._numerator ; 
+		if(this->_denominator == static_cast<T>(1)){
+			const T nb = this->_numerator ; 
+			*this = r.inverse() ; 
+			return *this *= nb ; 
+		}
+		bool overflow = false ; 
+		const wide_type num = OverflowPolicy::mul(wide(this->_numerator), wide(r._denominator), overflow) ; 
+		const wide_type den = OverflowPolicy::mul(wide(this->_denominator), wide(r._numerator), overflow) ; 
+		return *this = from_wide(num, den, overflow) ; 
+	}
+
+	/// @brief add an integer to the calling ratio, in place (no gcd : (n + nb*d)/d is coprime with d like n)
+    /// @param nb integer to add to the calling ratio 
+    /// @return the calling ratio, sum of itself and nb
+    constexpr Ratio& operator+= (const T nb)
+	noexcept(OverflowPolicy::is_noexcept){
+		bool overflow = false ; 
+		const wide_type num = OverflowPolicy::add(wide(this->_numerator), OverflowPolicy::mul(wide(this->_denominator), wide(nb), overflow), overflow) ; 
+		return *this = from_wide_reduced(num, wide(this->_denominator), overflow) ; 
+	}
+
+	/// @brief subtract an integer to the calling ratio, in place (no gcd : (n - nb*d)/d is coprime with d like n)
+    /// @param nb integer to subtract to the calling ratio 
+    /// @return the calling ratio, difference of itself and nb
+    constexpr Ratio& operator-= (const T nb)
+	noexcept(OverflowPolicy::is_noexcept){
+		bool overflow = false ; 
+		const wide_type num = OverflowPolicy::sub(wide(this->_numerator), OverflowPolicy::mul(wide(this->_denominator), wide(nb), overflow), overflow) ; 
+		return *this = from_wide_reduced(num, wide(this->_denominator), overflow) ; 
+	}
+
+	/// @brief multiply the calling ratio by an integer, in place (one gcd between nb and the denominator, none for an integer ratio)
+    /// @param nb integer to multiply to the calling ratio 
+    /// @return the calling ratio, product of itself and nb
+    constexpr Ratio& operator*= (const T nb)
+	noexcept(OverflowPolicy::is_noexcept){
+		bool overflow = false ; 
+		if(this->_denominator == static_cast<T>(1)){
+			const wide_type num = OverflowPolicy::mul(wide(this->_numerator), wide(nb), overflow) ; 
+			return *this = from_wide_reduced(num, wide(1), overflow) ; 
+		}
+		// n/d * nb = n*(nb/g) / (d/g), with g = gcd(nb, d)
+		const T pgcd = ratio_gcd(nb, this->_denominator) ; 
+		const T factor = (pgcd > static_cast<T>(1)) ? nb / pgcd : nb ; 
+		const T den = (pgcd > static_cast<T>(1)) ? this->_denominator / pgcd : this->_denominator ; 
+		const wide_type num = OverflowPolicy::mul(wide(this->_numerator), wide(factor), overflow) ; 
+		return *this = from_wide_reduced(num, wide(den), overflow) ; 
+	}
+
+	/// @brief divide the calling ratio by an integer, in place (one gcd between nb and the numerator)
+    /// @param nb integer to divide to the calling ratio 
+    /// @return the calling ratio, quotient of itself and nb
+    constexpr Ratio& operator/= (const T nb){
+		assert( (this->_denominator != 0) && "error: the denominator is null");
+		assert( (nb != 0) && "error: the denominator is null");
+		// n/d / nb = (n/g) / (d*(nb/g)), with g = gcd(n, nb)
+		const T pgcd = ratio_gcd(this->_numerator, nb) ; 
+		bool overflow = false ; 
+		wide_type num = wide(this->_numerator / pgcd) ; 
+		wide_type den = OverflowPolicy::mul(wide(this->_denominator), wide(nb / pgcd), overflow) ; 
+		if constexpr (std::is_signed<wide_type>::value){
+			if(den < static_cast<wide_type>(0)){
+				num = OverflowPolicy::sub(static_cast<wide_type>(0), num, overflow) ; 
+				den = OverflowPolicy::sub(static_cast<wide_type>(0), den, overflow) ; 
+			}
+		}
+		return *this = from_wide_reduced(num, den, overflow) ; 
 	}
 
 	/// @brief add 2 ratio of the same type
     /// @param r ratio to add to the calling ratio 
     /// @return the sum of the current ratio and the argument ratio
-    constexpr Ratio operator+ (const Ratio& r)
-	noexcept{
-		Ratio<T> result(this->_numerator*r._denominator+this->_denominator*r._numerator, this->_denominator*r._denominator); 
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
+    constexpr Ratio operator+ (const Ratio& r) const
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(*this) ; 
+		return result += r ; 
 	}
 
-    constexpr Ratio operator- (const Ratio& r)
-	noexcept{
-		Ratio<T> result(this->_numerator*r._denominator-this->_denominator*r._numerator, this->_denominator*r._denominator); 
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
+    /// @brief add a rational and an integer
+    /// @param nb integer to add to the calling ratio
+    /// @return the sum of the current ratio and the argument integer
+    constexpr Ratio operator+ (const T nb) const
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(*this) ; 
+		return result += nb ; 
+	}
+
+    /// @brief subtract 2 ratio of the same type
+    /// @param r ratio to subtract to the calling ratio 
+    /// @return the difference of the current ratio and the argument ratio
+    constexpr Ratio operator- (const Ratio& r) const
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(*this) ; 
+		return result -= r ; 
+	}
+
+    /// @brief subtract an integer to a rational
+    /// @param nb integer to subtract to the calling ratio
+    /// @return the difference of the current ratio and the argument integer
+    constexpr Ratio operator- (const T nb) const
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(*this) ; 
+		return result -= nb ; 
 	}
 
     /// @brief multiply 2 ratio of the same type
     /// @param r ratio to multiply to the calling ratio 
     /// @return a ratio corresponding to the multiplication of the current ratio and the argument ratio
-    constexpr Ratio operator* (const Ratio& r) 
-	noexcept{
-		Ratio<T> result((this->_numerator*r._numerator), (this->_denominator*r._denominator)) ; 
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
+    constexpr Ratio operator* (const Ratio& r) const
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(*this) ; 
+		return result *= r ; 
 	}
 
-    /// @brief multiply a rational and a int
-    /// @param nb int to multiply to the calling ratio
-    /// @return a ratio corresponding to the multiplication of the current ratio and the argument int
-    constexpr Ratio operator* (const int nb){	
-		Ratio<T> result((this->_numerator*nb),(this->_denominator));
-		result.reduce();
-		result.set_minus() ; 
-		return result;
+    /// @brief multiply a rational and an integer
+    /// @param nb integer to multiply to the calling ratio
+    /// @return a ratio corresponding to the multiplication of the current ratio and the argument integer
+    constexpr Ratio operator* (const T nb) const
+	noexcept(OverflowPolicy::is_noexcept){	
+		Ratio result(*this) ; 
+		return result *= nb ; 
 	}
 
     /// @brief divide 2 ratio of the same type
     /// @param r ratio to divide to the calling ratio 
     /// @return a ratio corresponding to the division of the current ratio and the argument ratio
-	constexpr Ratio operator/ (const Ratio& r){	
-		assert( (this->_denominator != 0) && "error: the denominator is null");
-		assert( (r._numerator != 0) && "error: the denominator is null");
-		Ratio<T> result((this->_numerator * r._denominator), (this->_denominator * r._numerator));
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
-}
+	constexpr Ratio operator/ (const Ratio& r) const{	
+		Ratio result(*this) ; 
+		return result /= r ; 
+	}
 
 	/// @brief divide ratio with a number 
 	/// @param nb nb to divide to the calling ratio 
 	/// @return a ratio corresponding to the division of the current ratio and the argument number
-	constexpr Ratio operator/(const int nb){
-		assert( (this->_denominator != 0) && "error: the denominator is null");
-		assert( (nb != 0) && "error: the denominator is null");
-		Ratio<T> result(this->_numerator, (this->_denominator * nb));
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
+	constexpr Ratio operator/(const T nb) const{
+		Ratio result(*this) ; 
+		return result /= nb ; 
 	}
 
-    /// @brief unary minus
+    /// @brief unary minus, the result is already irreducible (no gcd)
     /// @return the minus the calling ratio 
-    constexpr Ratio operator- () 
-	noexcept{	
-		Ratio<T> result(-this->_numerator, this->_denominator) ; 
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
+    constexpr Ratio operator- () const
+	noexcept(OverflowPolicy::is_noexcept){	
+		bool overflow = false ; 
+		const T num = OverflowPolicy::sub(static_cast<T>(0), this->_numerator, overflow) ; 
+		if constexpr (OverflowPolicy::detects_overflow){
+			if(overflow) return OverflowPolicy::template on_overflow<Ratio>() ;
+		}
+		return Ratio(num, this->_denominator, reduced_tag) ; 
 	} 
 
     /// @brief verifies equality between two ratio
     /// @param r ratio which is equal to the other
     /// @return a boolean indicating whether the ratio is equal to the argument ratio
-    constexpr bool operator== (const Ratio& r) 
+    constexpr bool operator== (const Ratio& r) const
 	noexcept{
 		return this->_numerator == r._numerator && this->_denominator == r._denominator ? true : false;
 	}
@@ -176,45 +648,41 @@ public :
 	/// @brief verifies equality between two ratio
     /// @param r ratio which is not equal to the other
     /// @return a boolean indicating whether the ratio is not equal to the argument ratio
-    constexpr bool operator!= (const Ratio& r) 
+    constexpr bool operator!= (const Ratio& r) const
 	noexcept{
-		return this->_numerator != r._numerator && this->_denominator != r._denominator ? true : false;
+		return !(*this == r) ;
 	}
 
 	/// @brief verifies if the argument is lower or equal to the calling ratio
     /// @param r ratio which is lower or equal to the other
     /// @return a boolean indicating whether the ratio is lower or equal to the argument ratio
-    constexpr bool operator<= (const Ratio& r)
+    constexpr bool operator<= (const Ratio& r) const
 	noexcept{
-		Ratio<T> result = (*this - r);
-		return result._numerator <= 0  ? true : false;
+		return compare(*this, r) <= 0 ;
 	}
 
 	/// @brief verifies if the argument is higher or equal to the calling ratio
     /// @param r ratio which is higher or equal to the other
     /// @return a boolean indicating whether the ratio is higher or equal to the argument ratio
-    constexpr bool operator>= (const Ratio& r) 
+    constexpr bool operator>= (const Ratio& r) const
 	noexcept{
-		Ratio<T> result = (*this - r);
-		return result._numerator >= 0 ? true : false;
+		return compare(*this, r) >= 0 ;
 	}
 
 	/// @brief verifies if the argument is lower to the calling ratio
     /// @param r ratio which is lower to the other
     /// @return a boolean indicating whether the ratio is lower to the argument ratio
-    constexpr bool operator< (const Ratio& r) 
+    constexpr bool operator< (const Ratio& r) const
 	noexcept{
-		Ratio<T> result = (*this - r);
-		return result._numerator < 0  ? true : false;
+		return compare(*this, r) < 0 ;
 	}
 
 	/// @brief verifies if the argument is higher  to the calling ratio
     /// @param r ratio which is higher  to the other
     /// @return a boolean indicating whether the ratio is higher  to the argument ratio
-    constexpr bool operator> (const Ratio& r) 
+    constexpr bool operator> (const Ratio& r) const
 	noexcept{
-		Ratio<T> result = (*this - r);
-		return result._numerator > 0 ? true : false;
+		return compare(*this, r) > 0 ;
 	}
 
 
@@ -224,83 +692,188 @@ public :
 	/// @brief display the ratio
     constexpr void display() const 
 	noexcept{
-		if (this->_denominator == 0)  std::cout << "inf" << std::endl ; 
-		else std::cout << this->_numerator << "/" << this->_denominator << std::endl;
+		std::cout << *this << std::endl ; 
 	}
 
 	/// @brief reduce the ratio to its irreducible form
 	constexpr void reduce() 
 	noexcept{
-		T pgcd = std::gcd(this->_numerator, this->_denominator); 
+		T pgcd = ratio_gcd(this->_numerator, this->_denominator); 
 		this->_numerator = this->_numerator/pgcd; 
 		this->_denominator = this->_denominator/pgcd; 
 	}
 
-	/// @brief if the ratio is negative, put the sign on the numerator
+	/// @brief if the ratio is negative, put the sign on the numerator (nothing to do for an unsigned T)
 	constexpr void set_minus() 
 	noexcept{
-		if((this->_numerator > 0 && this->_denominator < 0 )
-		|| (this->_numerator < 0 && this->_denominator < 0 ) ){
-			this->_numerator = -this->_numerator ; 
-			this->_denominator = -this->_denominator ; 
+		if constexpr (std::is_signed<T>::value){
+			if((this->_numerator > 0 && this->_denominator < 0 )
+			|| (this->_numerator < 0 && this->_denominator < 0 ) ){
+				this->_numerator = -this->_numerator ; 
+				this->_denominator = -this->_denominator ; 
+			}
 		}
 	}
 
-	/// @brief find the absolute value of a ratio, function with std 
+	/// @brief find the absolute value of a ratio, function with std (no gcd)
     /// @return the absolute value the calling ratio 
-	constexpr Ratio abs() 
+	constexpr Ratio abs() const
 	noexcept{
-		return Ratio<T>( std::abs(this->_numerator) , this->_denominator); 
+		if constexpr (std::is_signed<T>::value) return Ratio( std::abs(this->_numerator) , this->_denominator, reduced_tag); 
+		else return *this ; 
 	}
 
-	/// @brief find the absolute value of a ratio, our function without std
+	/// @brief find the absolute value of a ratio, our function without std (no gcd)
     /// @return the absolute value the calling ratio 
-	constexpr Ratio abs2() 
+	constexpr Ratio abs2() const
 	noexcept{
-		return (this->_numerator < static_cast<T>(0)) ? Ratio<T>( -this->_numerator , this->_denominator) : Ratio<T>(this->_numerator, this->_denominator) ;	
+		return is_negative(this->_numerator) ? Ratio( -this->_numerator , this->_denominator, reduced_tag) : *this ;	
 	}
 
 
 	/// @brief convert a ratio to a float rumber 
 	/// @return the ratio converted into a float
-	constexpr float convert_ratio_to_float() 
+	constexpr float convert_ratio_to_float() const
 	noexcept{
 		return (float)((float)this->_numerator / (float)this->_denominator) ; 
 	}
 
-	/// @brief inverse a ratio 
+	/// @brief convert a ratio to the nearest double (correctly rounded for every T)
+	/// @return the ratio converted into a double
+	constexpr double to_double() const
+	noexcept{
+		return this->to_floating_point<double>() ; 
+	}
+
+	/// @brief convert a ratio to the nearest float (correctly rounded for every T)
+	/// @return the ratio converted into a float
+	constexpr float to_float() const
+	noexcept{
+		return this->to_floating_point<float>() ; 
+	}
+
+	/// @brief inverse a ratio, swapping the components (no gcd)
 	/// @return the inverted ratio 
-	constexpr Ratio inverse() 
+	constexpr Ratio inverse() const
 	noexcept{
 		assert( (this->_denominator != 0) && "error: the denominator is null, impossible to inverse inf");
 		assert( (this->_numerator != 0) && "error: the numerator is null, impossible to inverse this ratio");
-		Ratio<T> result = Ratio<T>(this->_denominator, this->_numerator) ; 
-		result.set_minus(); 
-		return result; 
+		return is_negative(this->_numerator) ? Ratio(-this->_denominator, -this->_numerator, reduced_tag) : Ratio(this->_denominator, this->_numerator, reduced_tag) ; 
+	}
+
+	/// @brief closest ratio whose denominator is at most max_den (ties go to the smaller denominator).
+	/// Found by continued fraction descent : O(log) steps, the error is at most 1/(2*max_den).
+	/// @param max_den the maximal denominator, at least 1
+	/// @return the best approximation of the calling ratio with a bounded denominator
+	constexpr Ratio limit_denominator(const T max_den) const
+	noexcept{
+		assert( (max_den >= 1) && "error: the maximal denominator must be at least 1");
+		if(this->_denominator <= max_den) return *this ; 
+
+		// the continued fraction runs on the magnitudes, valid even for the minimum of T
+		using U = magnitude_type ; 
+		const bool negative = is_negative(this->_numerator) ; 
+		const U max = magnitude(max_den) ; 
+		U n = magnitude(this->_numerator) ; 
+		U d = magnitude(this->_denominator) ; 
+
+		// convergents p0/q0 and p1/q1, n/d being the remaining complete quotient
+		U p0 = 0, q0 = 1, p1 = 1, q1 = 0 ; 
+		while(true){
+			const U a = n / d ; 
+			if(q1 != 0 && a > (max - q0) / q1) break ; 
+			const U p2 = p0 + a*p1 ; 
+			const U q2 = q0 + a*q1 ; 
+			p0 = p1 ; q0 = q1 ; 
+			p1 = p2 ; q1 = q2 ; 
+			const U r = n - a*d ; 
+			n = d ; 
+			d = r ; 
+		}
+
+		// best semiconvergent and last convergent, on both sides of the ratio (their numerators are below |numerator|)
+		const U k = (max - q0) / q1 ; 
+		const Ratio semiconvergent(static_cast<T>(p0 + k*p1), static_cast<T>(q0 + k*q1), reduced_tag) ; 
+		const Ratio convergent(static_cast<T>(p1), static_cast<T>(q1), reduced_tag) ; 
+
+		// the convergent is at least as close iff q0 + 2*k*q1 <= q1 * n/d, that is (q0 + k*q1)/q1 <= (n - k*d)/d
+		bool convergent_is_closer = false ; 
+		if constexpr (has_wider<T>::value){
+			using W = wider_t<T> ; 
+			convergent_is_closer = (static_cast<W>(q0 + k*q1) + static_cast<W>(k)*static_cast<W>(q1)) * static_cast<W>(d)
+			                       <= static_cast<W>(q1) * static_cast<W>(n) ; 
+		}
+		else convergent_is_closer = compare_magnitudes(q0 + k*q1, q1, n - k*d, d) <= 0 ; 
+		const Ratio result = convergent_is_closer ? convergent : semiconvergent ; 
+		return negative ? Ratio(-result._numerator, result._denominator, reduced_tag) : result ; 
 	}
 
 
 /*------------------- STATIC METHODES ---------------------*/
 
+	/// @brief convert an array of ratios to doubles, each one correctly rounded
+	/// @param ratios the ratios to convert
+	/// @param count number of ratios
+	/// @param out array of count doubles receiving the result
+	static void to_double(const Ratio* ratios, const std::size_t count, double* out)
+	noexcept{
+		to_floating_point<double>(ratios, count, out) ; 
+	}
+
+	/// @brief convert an array of ratios to floats, each one correctly rounded
+	/// @param ratios the ratios to convert
+	/// @param count number of ratios
+	/// @param out array of count floats receiving the result
+	static void to_float(const Ratio* ratios, const std::size_t count, float* out)
+	noexcept{
+		to_floating_point<float>(ratios, count, out) ; 
+	}
+
 	/// @brief the zero-valued rational
 	/// @return 0.0/1.0
 	constexpr static Ratio zero() 
 	noexcept{
-		return Ratio<T>(0.0,1.0); 
+		return Ratio(0, 1, reduced_tag); 
 	}
 
 	/// @brief the rational corresponding to the value one
 	/// @return 1.0/1.0
 	constexpr static Ratio one() 
 	noexcept{
-		return Ratio<T>(1.0,1.0); 
+		return Ratio(1, 1, reduced_tag); 
 	}
 
 	/// @brief the rational correspondind to infinity
 	/// @return 1.0/0.0
 	constexpr static Ratio inf() 
 	noexcept{
-		return Ratio<T>(1.0,0.0); 
+		return Ratio(1, 0, reduced_tag); 
+	}
+
+	/// @brief irreducible ratio from a numerator and a denominator computed in a wider integer type
+	/// @param num numerator, in the wide type W
+	/// @param den denominator, in the wide type W
+	/// @param overflow set to true if the reduced ratio does not fit in T
+	/// @return num/den reduced, zero if it does not fit in T
+	template<class W>
+	constexpr static Ratio reduce_wide(W num, W den, bool& overflow)
+	noexcept{
+		const W pgcd = ratio_gcd(num, den) ; 
+		if(pgcd != 0){
+			num = num/pgcd ; 
+			den = den/pgcd ; 
+		}
+		if constexpr (std::is_signed<W>::value){
+			if(den < 0){
+				num = -num ; 
+				den = -den ; 
+			}
+		}
+		if(!fits(num) || !fits(den)){
+			overflow = true ; 
+			return zero() ; 
+		}
+		return Ratio(static_cast<T>(num), static_cast<T>(den), reduced_tag) ; 
 	}
 
 	/// @brief convert a real number to a Ratio
@@ -308,32 +881,103 @@ public :
 	/// @param nb_iter number of recursive call 
 	/// @return  the real converted into a rational 
 	constexpr static Ratio convert_float_to_ratio(const float x, const int nb_iter) 
-	noexcept{
+	noexcept(OverflowPolicy::is_noexcept){
 		if (x==0 || nb_iter==0) return zero() ;
 		if (x<0){
 			return -(convert_float_to_ratio(-x,nb_iter));
 		}
 		if(x<1){
-			return Ratio<T>(1.0, (convert_float_to_ratio( (float)1.0/x, nb_iter ).convert_ratio_to_float()) ); 
+			return Ratio(1.0, (convert_float_to_ratio( (float)1.0/x, nb_iter ).convert_ratio_to_float()) ); 
 		}
 		float q = (int)x; 
-		Ratio<T> result(Ratio<T>(q,1.0) + convert_float_to_ratio(x-q, nb_iter-1)); 
-		result.reduce() ; 
-		result.set_minus() ;
-		return result; 
+		return Ratio(q,1.0) + convert_float_to_ratio(x-q, nb_iter-1); 
+	}
+
+	/// @brief compare 2 ratios by cross multiplication in the wide type, without subtraction nor gcd
+	/// @param a a ratio
+	/// @param b another ratio
+	/// @return a negative number if a < b, 0 if a == b, a positive number if a > b
+	constexpr static int compare(const Ratio& a, const Ratio& b)
+	noexcept{
+		if constexpr (has_wider<T>::value){
+			using W = wider_t<T> ; 
+			const W left = static_cast<W>(a._numerator) * static_cast<W>(b._denominator) ; 
+			const W right = static_cast<W>(b._numerator) * static_cast<W>(a._denominator) ; 
+			return (left < right) ? -1 : ((left > right) ? 1 : 0) ; 
+		}
+		else {
+			// 128 bits : the signs first, then the magnitudes without products
+			const int sign_a = is_negative(a._numerator) ? -1 : ((a._numerator == 0) ? 0 : 1) ; 
+			const int sign_b = is_negative(b._numerator) ? -1 : ((b._numerator == 0) ? 0 : 1) ; 
+			if(sign_a != sign_b) return (sign_a < sign_b) ? -1 : 1 ; 
+			const int result = compare_magnitudes(magnitude(a._numerator), magnitude(a._denominator), magnitude(b._numerator), magnitude(b._denominator)) ; 
+			return (sign_a < 0) ? -result : result ; 
+		}
+	}
+
+	/// @brief simplest ratio (smallest denominator, then smallest numerator) in the interval [lo, hi].
+	/// Found by Stern-Brocot descent, one continued fraction term per step.
+	/// @param lo bound of the interval
+	/// @param hi other bound of the interval
+	/// @return the simplest ratio between lo and hi
+	constexpr static Ratio simplest_between(Ratio lo, Ratio hi)
+	noexcept(OverflowPolicy::is_noexcept){
+		if(hi < lo){
+			const Ratio tmp = lo ; 
+			lo = hi ; 
+			hi = tmp ; 
+		}
+		if(lo._numerator <= 0 && !is_negative(hi._numerator)) return zero() ; 
+		if(is_negative(hi._numerator)){
+			const Ratio result = simplest_between(Ratio(-hi._numerator, hi._denominator, reduced_tag), Ratio(-lo._numerator, lo._denominator, reduced_tag)) ; 
+			return Ratio(-result._numerator, result._denominator, reduced_tag) ; 
+		}
+
+		// 0 < x = xn/xd <= y = yn/yd
+		T xn = lo._numerator, xd = lo._denominator ; 
+		T yn = hi._numerator, yd = hi._denominator ; 
+		T p0 = 0, q0 = 1, p1 = 1, q1 = 0 ; 
+		T term ; 
+		while(true){
+			const T a = xn / xd ; 
+			if(a*xd == xn){
+				term = a ; 
+				break ; 
+			}
+			if(yd == 0 || a + 1 <= yn / yd){
+				term = a + 1 ; 
+				break ; 
+			}
+			// x and y share the integer part a : continue with x' = 1/(y-a) and y' = 1/(x-a)
+			const T p2 = p0 + a*p1 ; 
+			const T q2 = q0 + a*q1 ; 
+			p0 = p1 ; q0 = q1 ; 
+			p1 = p2 ; q1 = q2 ; 
+			const T next_xn = yd, next_xd = yn - a*yd ; 
+			yn = xd ; 
+			yd = xn - a*xd ; 
+			xn = next_xn ; 
+			xd = next_xd ; 
+		}
+		return Ratio(p0 + term*p1, q0 + term*q1, reduced_tag) ; 
 	}
 
-	/// @brief calcul a ratio to the power n 
+	/// @brief calcul a ratio to the power n, exactly by squaring (the powers of coprime components stay coprime, no gcd)
 	/// @param r a ratio
-	/// @param n exponent 
+	/// @param n exponent, negative for a power of the inverse
 	/// @return the ratio to the power n
 	constexpr static Ratio pow(const Ratio& r, const int n)
-	noexcept{
-		if(n==0) return Ratio<T>::one() ;
-		Ratio<T> result = Ratio<T>(std::pow(r._numerator, n), std::pow(r._denominator, n)); 
-		result.reduce() ;
-		result.set_minus() ;	 
-		return result; 
+	noexcept(OverflowPolicy::is_noexcept){
+		if(n==0) return Ratio::one() ;
+		const Ratio base = (n < 0) ? r.inverse() : r ; 
+		const unsigned int e = (n < 0) ? 0u - static_cast<unsigned int>(n) : static_cast<unsigned int>(n) ; 
+		bool overflow = false ; 
+		const T num = power(base._numerator, e, overflow) ; 
+		const T den = power(base._denominator, e, overflow) ; 
+		if constexpr (OverflowPolicy::detects_overflow){
+			if(overflow) return OverflowPolicy::template on_overflow<Ratio>() ;
+		}
+		return Ratio(num, den, reduced_tag) ; 
 	}
 
 	/// @brief calcul a ratio to the power n, its our fonction pow, not the best...
@@ -341,14 +985,13 @@ public :
 	/// @param n exponent 
 	/// @return the ratio to the power n
 	constexpr static Ratio pow2(const Ratio& r, const int n)
-	noexcept{
+	noexcept(OverflowPolicy::is_noexcept){
 		assert( (n > 0 ) && "error: n is negativ. ");
-		if(n==0) return Ratio<T>::one() ;
-		Ratio<T> result = r; 
-		for (size_t i = 0; i < n-1; i++){
-			result = result*r ; 
+		if(n==0) return Ratio::one() ;
+		Ratio result = r; 
+		for (int i = 0; i < n-1; i++){
+			result *= r ; 
 		}
-		result.reduce() ; 
 		return result; 
 	}
 
@@ -416,12 +1059,12 @@ public :
 	/// @param r ratio
 	/// @return the tcos of a ratio
 	constexpr static float taylor_cos(const Ratio& r)
-	noexcept{
+	noexcept(OverflowPolicy::is_noexcept){
 		float result = 0.; 
-		Ratio<T> r1(-1,1);
+		Ratio r1(-1,1);
 		int n = 16;
 		for (int i = 0; i < n; i++){
-			result = result + (pow(r1, i)*pow(r, 2*i)).convert_ratio_to_float()/factorial(2*i); 
+			result += (pow(r1, i)*pow(r, 2*i)).convert_ratio_to_float()/factorial(2*i); 
 		}
 		return result;
 	}
@@ -436,31 +1079,75 @@ public :
     /// \param stream : input stream
     /// \param r : the ratio to output
     /// \return the output stream containing the ratio data
-	friend std::ostream& operator<< (std::ostream& stream, const Ratio<T>& r) {			
-		return (r._denominator == 0) ? stream << "inf" : stream << r._numerator << "/" << r._denominator ; 
+	friend std::ostream& operator<< (std::ostream& stream, const Ratio& r) {			
+		if(r._denominator == 0) return stream << "inf" ; 
+		if constexpr (std::numeric_limits<T>::digits <= 64) return stream << r._numerator << "/" << r._denominator ; 
+		else {
+			// the streams do not print 128 bits integers
+			char buffer[2 * (std::numeric_limits<T>::digits10 + 2) + 1] ; 
+			char* const last = buffer + sizeof(buffer) ; 
+			char* p = ratio_to_chars(buffer, last, r._numerator).ptr ; 
+			*p++ = '/' ; 
+			p = ratio_to_chars(p, last, r._denominator).ptr ; 
+			return stream.write(buffer, p - buffer) ; 
+		}
 	}; 
 
+	/// @brief add an integer and a ratio
+	/// @param nb integer to add to the ratio
+	/// @param r the ratio
+	/// @return the sum of the integer and the ratio
+	friend constexpr Ratio operator+ (const T nb, const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(r) ; 
+		return result += nb ; 
+	}
+
+	/// @brief subtract a ratio to an integer
+	/// @param nb integer from which the ratio is subtracted
+	/// @param r the ratio
+	/// @return the difference of the integer and the ratio
+	friend constexpr Ratio operator- (const T nb, const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(nb, static_cast<T>(1), reduced_tag) ; 
+		return result -= r ; 
+	}
+
 	/// @brief divide a number with a ratio
 	/// @param nb number to divide to the ratio 
 	/// @param r the ratio 
 	/// @return a ratio corresponding to the division of the ratio and the number
-	friend Ratio<T> operator/ (const int nb, const Ratio<T>& r){
-		assert( (r._numerator != 0) && "error: the denominator is null");
-		Ratio<T> result((r._denominator * nb), r._numerator);
-		result.reduce() ; 
-		result.set_minus() ; 
-		return result; 
-	}; 
+	friend constexpr Ratio operator/ (const T nb, const Ratio& r){
+		Ratio result(nb, static_cast<T>(1), reduced_tag) ; 
+		return result /= r ; 
+	}
 
-	/// @brief multiply a rational and a int or a long int
+	/// @brief multiply an integer and a ratio
 	/// @param nb number to multiply to the ratio
 	/// @param r ratio to multiply to the number
 	/// @return a ratio corresponding to the multiplication of the ratio and the number
-	friend Ratio<T> operator* (const int nb, const Ratio<T>& r){
-		Ratio<T> result((r._numerator*nb),(r._denominator));
-		result.reduce();
-		result.set_minus() ; 
-		return result;
-	};
+	friend constexpr Ratio operator* (const T nb, const Ratio& r)
+	noexcept(OverflowPolicy::is_noexcept){
+		Ratio result(r) ; 
+		return result *= nb ; 
+	}
 
 };	
+
+
+/*------------------- EXPLICIT INSTANTIATIONS ---------------------*/
+
+// Ratio<int>, Ratio<long int>, Ratio<long long int>, their unsigned versions and Ratio<ratio_int128> are compiled once,
+// in the Ratio library (src/Ratio.cpp) : the other translation units link against them instead of instantiating them again.
+// Define RATIO_NO_EXTERN_TEMPLATE to instantiate them in every translation unit (header only use, without the library).
+#ifndef RATIO_NO_EXTERN_TEMPLATE
+extern template class Ratio<int> ;
+extern template class Ratio<long int> ;
+extern template class Ratio<long long int> ;
+extern template class Ratio<unsigned int> ;
+extern template class Ratio<unsigned long int> ;
+extern template class Ratio<unsigned long long int> ;
+#if defined(RATIO_HAS_INT128_TRAITS)
+extern template class Ratio<ratio_int128> ;
+#endif
+#endif
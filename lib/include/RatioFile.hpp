@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "RatioFile.hpp requires POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+// Columnar file of irreducible ratios, read back by mapping the file in memory :
+//
+//   [ header (128 bytes) | numerators (count * width bytes) | padding | denominators (count * width bytes) ]
+//
+// The columns are stored in the byte order of the machine and start on a 64 bytes boundary, so the mapped
+// columns are used in place as arrays of T : opening a file reads only the header, the pages of the columns
+// are loaded by the kernel when they are first accessed, and the processes mapping the same file share them.
+
+namespace ratio_file {
+
+	/// @brief first bytes of a ratio file
+	inline constexpr char magic[8] = {'R', 'A', 'T', 'I', 'O', 'C', 'O', 'L'} ;
+
+	/// @brief version of the format
+	inline constexpr std::uint32_t version = 1 ;
+
+	/// @brief written in the byte order of the machine, detects a file written with the other byte order
+	inline constexpr std::uint32_t byte_order_mark = 0x01020304 ;
+
+	/// @brief alignment of the columns in the file
+	inline constexpr std::uint64_t column_alignment = 64 ;
+
+	/// @brief header of a ratio file
+	struct Header {
+		char magic[8] ;
+		std::uint32_t version ;
+		std::uint32_t byte_order ;
+		/// @brief size in bytes of the integer type of the components
+		std::uint32_t width ;
+		/// @brief 1 if the integer type is signed
+		std::uint32_t is_signed ;
+		/// @brief number of ratios
+		std::uint64_t count ;
+		/// @brief position of the numerator column in the file
+		std::uint64_t numerator_offset ;
+		/// @brief position of the denominator column in the file
+		std::uint64_t denominator_offset ;
+		/// @brief checksum of the bytes of the numerator column
+		std::uint64_t numerator_checksum ;
+		/// @brief checksum of the bytes of the denominator column
+		std::uint64_t denominator_checksum ;
+		std::uint64_t reserved[7] ;
+		/// @brief checksum of the previous fields
+		std::uint64_t header_checksum ;
+	};
+
+	static_assert(sizeof(Header) == 128 && std::is_trivially_copyable<Header>::value, "the header must have a fixed layout");
+
+	/// @brief FNV-1a hash, by words of 64 bits, continued from h
+	/// @param data bytes to hash
+	/// @param size number of bytes
+	/// @param h hash of the previous bytes
+	inline std::uint64_t checksum(const void* data, const std::size_t size, std::uint64_t h = 0xcbf29ce484222325ULL)
+	noexcept{
+		constexpr std::uint64_t prime = 0x100000001b3ULL ;
+		const unsigned char* bytes = static_cast<const unsigned char*>(data) ;
+		std::size_t i = 0 ;
+		for(; i + 8 <= size; i += 8){
+			std::uint64_t word ;
+			std::memcpy(&word, bytes + i, 8) ;
+			h = (h ^ word) * prime ;
+		}
+		for(; i < size; ++i) h = (h ^ bytes[i]) * prime ;
+		return h ;
+	}
+
+	/// @brief checksum of the fields of a header preceding header_checksum
+	inline std::uint64_t header_checksum(const Header& header)
+	noexcept{
+		return checksum(&header, offsetof(Header, header_checksum)) ;
+	}
+
+	/// @brief first multiple of column_alignment not lower than offset
+	constexpr std::uint64_t align(const std::uint64_t offset) noexcept{ return (offset + column_alignment - 1) / column_alignment * column_alignment ; }
+
+	/// @brief header of a file of count ratios with components of type T, without the column checksums
+	template<class T>
+	Header make_header(const std::uint64_t count)
+	noexcept{
+		Header header{} ;
+		std::memcpy(header.magic, magic, sizeof(magic)) ;
+		header.version = version ;
+		header.byte_order = byte_order_mark ;
+		header.width = sizeof(T) ;
+		header.is_signed = std::is_signed<T>::value ? 1 : 0 ;
+		header.count = count ;
+		header.numerator_offset = align(sizeof(Header)) ;
+		header.denominator_offset = align(header.numerator_offset + count * sizeof(T)) ;
+		return header ;
+	}
+
+	/// @brief read-only array of a column, used in place in the mapped file
+	template<class T>
+	class Column {
+
+	private :
+		/// @brief first element
+		const T* _data ;
+		/// @brief number of elements
+		std::size_t _size ;
+
+	public :
+		/// @brief view of size elements starting at data
+		constexpr Column(const T* data = nullptr, const std::size_t size = 0) noexcept : _data(data), _size(size) {}
+
+		/// @brief first element
+		constexpr const T* data() const noexcept{ return _data ; }
+		/// @brief number of elements
+		constexpr std::size_t size() const noexcept{ return _size ; }
+		/// @brief true if the column has no element
+		constexpr bool empty() const noexcept{ return _size == 0 ; }
+		/// @brief iterators on the elements
+		constexpr const T* begin() const noexcept{ return _data ; }
+		constexpr const T* end() const noexcept{ return _data + _size ; }
+
+		/// @brief element i
+		constexpr const T& operator[] (const std::size_t i) const
+		noexcept{
+			assert( (i < _size) && "error: index out of range");
+			return _data[i] ;
+		}
+	};
+
+}
+
+
+/// @brief write ratios in a columnar file, read back with MappedRatioFile
+/// @param path name of the file, replaced if it exists
+/// @param ratios the ratios
+/// @param count number of ratios
+/// Throws std::system_error if the file cannot be written.
+template<class T, class OverflowPolicy>
+void write_ratio_file(const std::string& path, const Ratio<T, OverflowPolicy>* ratios, const std::size_t count)
+{
+	static_assert(std::is_integral<T>::value, "Integral required.");
+	ratio_file::Header header = ratio_file::make_header<T>(count) ;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc) ;
+	if(!file) throw std::system_error(errno, std::generic_category(), "RatioFile: cannot create " + path) ;
+
+	// the header is written again at the end, when the checksums are known
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ;
+	const char zeros[ratio_file::column_alignment] = {} ;
+	file.write(zeros, static_cast<std::streamsize>(header.numerator_offset - sizeof(header))) ;
+
+	// one column after the other, through a buffer of components
+	constexpr std::size_t buffer_size = 4096 ;
+	std::vector<T> buffer(buffer_size) ;
+	auto write_column = [&](const bool numerators){
+		std::uint64_t h = ratio_file::checksum(nullptr, 0) ;
+		for(std::size_t first = 0; first < count; first += buffer_size){
+			const std::size_t n = std::min(buffer_size, count - first) ;
+			for(std::size_t i = 0; i < n; ++i) buffer[i] = numerators ? ratios[first+i].get_numerator() : ratios[first+i].get_denominator() ;
+			h = ratio_file::checksum(buffer.data(), n * sizeof(T), h) ;
+			file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(n * sizeof(T))) ;
+		}
+		return h ;
+	} ;
+
+	header.numerator_checksum = write_column(true) ;
+	file.write(zeros, static_cast<std::streamsize>(header.denominator_offset - header.numerator_offset - count * sizeof(T))) ;
+	header.denominator_checksum = write_column(false) ;
+	header.header_checksum = ratio_file::header_checksum(header) ;
+
+	file.seekp(0) ;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ;
+	file.flush() ;
+	if(!file) throw std::system_error(errno, std::generic_category(), "RatioFile: cannot write " + path) ;
+}
+
+/// @brief write ratios in a columnar file, read back with MappedRatioFile
+/// @param path name of the file, replaced if it exists
+/// @param ratios the ratios
+template<class T, class OverflowPolicy>
+void write_ratio_file(const std::string& path, const std::vector<Ratio<T, OverflowPolicy>>& ratios)
+{
+	write_ratio_file(path, ratios.data(), ratios.size()) ;
+}
+
+
+/// @class MappedRatioFile
+/// @brief read-only view of a columnar ratio file (see write_ratio_file), mapped in memory.
+/// Nothing is parsed nor copied : the numerators and the denominators are read in place in the mapped pages,
+/// which the kernel loads on first access and shares between the processes mapping the same file.
+/// @tparam T integer type of the components, the one the file was written with
+/// @tparam OverflowPolicy overflow policy of the ratios returned by operator[]
+template<class T, class OverflowPolicy = overflow::Wrap>
+class MappedRatioFile {
+
+private :
+	/// @brief start of the mapping
+	void* _address ;
+	/// @brief length of the mapping
+	std::size_t _length ;
+	/// @brief header of the file, in the mapping
+	const ratio_file::Header* _header ;
+	/// @brief numerator column
+	ratio_file::Column<T> _numerators ;
+	/// @brief denominator column
+	ratio_file::Column<T> _denominators ;
+
+	/// @brief check the header against T and the size of the file, throw std::runtime_error if they do not match
+	static void check(const ratio_file::Header& header, const std::size_t length)
+	{
+		if(std::memcmp(header.magic, ratio_file::magic, sizeof(ratio_file::magic)) != 0) throw std::runtime_error("RatioFile: not a ratio file") ;
+		if(header.header_checksum != ratio_file::header_checksum(header)) throw std::runtime_error("RatioFile: corrupted header") ;
+		if(header.version != ratio_file::version) throw std::runtime_error("RatioFile: unsupported version") ;
+		if(header.byte_order != ratio_file::byte_order_mark) throw std::runtime_error("RatioFile: written with another byte order") ;
+		if(header.width != sizeof(T) || header.is_signed != (std::is_signed<T>::value ? 1u : 0u)) throw std::runtime_error("RatioFile: written with another integer type") ;
+		if(header.numerator_offset % ratio_file::column_alignment != 0 || header.denominator_offset % ratio_file::column_alignment != 0
+		|| header.denominator_offset > length || header.count > (length - header.denominator_offset) / sizeof(T)
+		|| header.numerator_offset + header.count * sizeof(T) > header.denominator_offset){
+			throw std::runtime_error("RatioFile: truncated file") ;
+		}
+	}
+
+	/// @brief unmap the file
+	void release()
+	noexcept{
+		if(_address != nullptr) munmap(_address, _length) ;
+		_address = nullptr ;
+		_length = 0 ;
+		_header = nullptr ;
+		_numerators = ratio_file::Column<T>() ;
+		_denominators = ratio_file::Column<T>() ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief map a ratio file ; only its header is read
+	/// @param path name of the file
+	/// Throws std::system_error if the file cannot be mapped, std::runtime_error if it is not a valid file of ratios of T.
+	explicit MappedRatioFile(const std::string& path)
+	: _address(nullptr), _length(0), _header(nullptr), _numerators(), _denominators() {
+		static_assert(std::is_integral<T>::value, "Integral required.");
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC) ;
+		if(fd < 0) throw std::system_error(errno, std::generic_category(), "RatioFile: cannot open " + path) ;
+		struct stat status ;
+		if(::fstat(fd, &status) != 0){
+			const int error = errno ;
+			::close(fd) ;
+			throw std::system_error(error, std::generic_category(), "RatioFile: cannot stat " + path) ;
+		}
+		_length = static_cast<std::size_t>(status.st_size) ;
+		if(_length < sizeof(ratio_file::Header)){
+			::close(fd) ;
+			throw std::runtime_error("RatioFile: not a ratio file") ;
+		}
+		// the mapping stays valid once the descriptor is closed
+		void* address = ::mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0) ;
+		const int error = errno ;
+		::close(fd) ;
+		if(address == MAP_FAILED) throw std::system_error(error, std::generic_category(), "RatioFile: cannot map " + path) ;
+		_address = address ;
+
+		_header = static_cast<const ratio_file::Header*>(_address) ;
+		try {
+			check(*_header, _length) ;
+		}
+		catch(...){
+			release() ;
+			throw ;
+		}
+		const char* bytes = static_cast<const char*>(_address) ;
+		const std::size_t count = static_cast<std::size_t>(_header->count) ;
+		_numerators = ratio_file::Column<T>(reinterpret_cast<const T*>(bytes + _header->numerator_offset), count) ;
+		_denominators = ratio_file::Column<T>(reinterpret_cast<const T*>(bytes + _header->denominator_offset), count) ;
+	}
+
+	MappedRatioFile(const MappedRatioFile&) = delete ;
+	MappedRatioFile& operator=(const MappedRatioFile&) = delete ;
+
+	/// @brief move-constructor, r is left empty
+	MappedRatioFile(MappedRatioFile&& r)
+	noexcept : _address(r._address), _length(r._length), _header(r._header), _numerators(r._numerators), _denominators(r._denominators) {
+		r._address = nullptr ;
+		r.release() ;
+	}
+
+	/// @brief move-assignment, r is left empty
+	MappedRatioFile& operator=(MappedRatioFile&& r)
+	noexcept{
+		if(&r == this) return *this ;
+		release() ;
+		std::swap(_address, r._address) ;
+		std::swap(_length, r._length) ;
+		std::swap(_header, r._header) ;
+		std::swap(_numerators, r._numerators) ;
+		std::swap(_denominators, r._denominators) ;
+		return *this ;
+	}
+
+	/// @brief destructor, unmap the file
+	~MappedRatioFile()
+	{
+		release() ;
+	}
+
+
+/*------------------- GETTERS ---------------------*/
+
+	/// @brief number of ratios
+	std::size_t size() const noexcept{ return _numerators.size() ; }
+
+	/// @brief true if the file has no ratio
+	bool empty() const noexcept{ return _numerators.empty() ; }
+
+	/// @brief numerators of the ratios, in place in the file
+	ratio_file::Column<T> numerators() const noexcept{ return _numerators ; }
+
+	/// @brief denominators of the ratios, in place in the file
+	ratio_file::Column<T> denominators() const noexcept{ return _denominators ; }
+
+	/// @brief ratio i, built from its components without gcd (they were written irreducible)
+	/// @param i index of the ratio
+	Ratio<T, OverflowPolicy> operator[] (const std::size_t i) const
+	noexcept{
+		return Ratio<T, OverflowPolicy>(_numerators[i], _denominators[i], reduced_tag) ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief recompute the checksums of the columns ; reads the whole file
+	/// @return true if the columns are intact
+	bool verify() const
+	noexcept{
+		return ratio_file::checksum(_numerators.data(), _numerators.size() * sizeof(T)) == _header->numerator_checksum
+		    && ratio_file::checksum(_denominators.data(), _denominators.size() * sizeof(T)) == _header->denominator_checksum ;
+	}
+
+	/// @brief tell the kernel the whole file will be read soon (read-ahead), for a full scan
+	void will_need() const
+	noexcept{
+		if(_address != nullptr) ::madvise(_address, _length, MADV_WILLNEED) ;
+	}
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "Ratio.hpp"
+
+
+
+/// @class RatioIndex
+/// @brief read-optimized ordered index from ratio keys to values, for range queries "all the keys in [a, b]".
+/// The keys are stored sorted in one contiguous array (the values in another one, same order) and compared exactly by cross multiplication.
+/// The index is built in bulk, and updated by merging a sorted batch instead of inserting nodes one by one.
+/// @tparam T can be : int, long int
+/// @tparam V type of the values
+template<class T, class V>
+class RatioIndex {
+
+public :
+	/// @brief an entry of the index
+	using entry_type = std::pair<Ratio<T>, V> ;
+
+private :
+	/// @brief sorted keys
+	std::vector<Ratio<T>> _keys ;
+	/// @brief values, _values[i] belongs to _keys[i]
+	std::vector<V> _values ;
+
+	/// @brief strict order on the keys
+	static bool less(const Ratio<T>& a, const Ratio<T>& b)
+	noexcept{
+		return Ratio<T>::compare(a, b) < 0 ;
+	}
+
+	/// @brief sort entries by key, keeping the order of equal keys
+	static void sort(std::vector<entry_type>& entries)
+	{
+		std::stable_sort(entries.begin(), entries.end(), [](const entry_type& a, const entry_type& b){ return less(a.first, b.first) ; }) ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief empty index
+	RatioIndex() = default ;
+
+	/// @brief bulk build
+	/// @param entries the entries, in any order
+	explicit RatioIndex(std::vector<entry_type> entries)
+	{
+		sort(entries) ;
+		_keys.reserve(entries.size()) ;
+		_values.reserve(entries.size()) ;
+		for(entry_type& entry : entries){
+			_keys.push_back(entry.first) ;
+			_values.push_back(std::move(entry.second)) ;
+		}
+	}
+
+
+/*------------------- GETTERS ---------------------*/
+
+	/// @brief number of entries
+	std::size_t size() const noexcept{ return _keys.size() ; }
+
+	/// @brief true if the index has no entry
+	bool empty() const noexcept{ return _keys.empty() ; }
+
+	/// @brief key of rank i
+	const Ratio<T>& key(const std::size_t i) const noexcept{ return _keys[i] ; }
+
+	/// @brief value of rank i
+	const V& value(const std::size_t i) const noexcept{ return _values[i] ; }
+
+	/// @brief value of rank i
+	V& value(const std::size_t i) noexcept{ return _values[i] ; }
+
+
+/*------------------- SEARCH ---------------------*/
+
+	/// @brief rank of the first key not lower than key (branchless binary search)
+	/// @param key the searched key
+	/// @return an index in [0, size()]
+	std::size_t lower_bound(const Ratio<T>& key) const
+	noexcept{
+		if(_keys.empty()) return 0 ;
+		const Ratio<T>* base = _keys.data() ;
+		std::size_t length = _keys.size() ;
+		while(length > 1){
+			const std::size_t half = length / 2 ;
+			base = less(base[half - 1], key) ? base + half : base ;
+			length -= half ;
+		}
+		return static_cast<std::size_t>(base - _keys.data()) + (less(*base, key) ? 1 : 0) ;
+	}
+
+	/// @brief rank of the first key greater than key (branchless binary search)
+	/// @param key the searched key
+	/// @return an index in [0, size()]
+	std::size_t upper_bound(const Ratio<T>& key) const
+	noexcept{
+		if(_keys.empty()) return 0 ;
+		const Ratio<T>* base = _keys.data() ;
+		std::size_t length = _keys.size() ;
+		while(length > 1){
+			const std::size_t half = length / 2 ;
+			base = less(key, base[half - 1]) ? base : base + half ;
+			length -= half ;
+		}
+		return static_cast<std::size_t>(base - _keys.data()) + (less(key, *base) ? 0 : 1) ;
+	}
+
+	/// @brief ranks of the keys in [lo, hi]
+	/// @param lo lower bound of the keys
+	/// @param hi upper bound of the keys
+	/// @return the ranks [first, last) of the matching entries
+	std::pair<std::size_t, std::size_t> range(const Ratio<T>& lo, const Ratio<T>& hi) const
+	noexcept{
+		const std::size_t first = lower_bound(lo) ;
+		const std::size_t last = std::max(first, upper_bound(hi)) ;
+		return std::make_pair(first, last) ;
+	}
+
+	/// @brief call f(key, value) on every entry whose key is in [lo, hi], in increasing order of the keys
+	/// @param lo lower bound of the keys
+	/// @param hi upper bound of the keys
+	/// @param f function taking a const Ratio<T>& and a const V&
+	template<class Function>
+	void for_each_in(const Ratio<T>& lo, const Ratio<T>& hi, Function f) const
+	{
+		const std::pair<std::size_t, std::size_t> ranks = range(lo, hi) ;
+		for(std::size_t i = ranks.first; i < ranks.second; ++i) f(_keys[i], _values[i]) ;
+	}
+
+
+/*------------------- UPDATE ---------------------*/
+
+	/// @brief add a batch of entries : the batch is sorted, then merged with the index in one linear pass
+	/// @param entries the new entries, in any order
+	void insert(std::vector<entry_type> entries)
+	{
+		sort(entries) ;
+		std::vector<Ratio<T>> keys ;
+		std::vector<V> values ;
+		keys.reserve(_keys.size() + entries.size()) ;
+		values.reserve(_keys.size() + entries.size()) ;
+
+		std::size_t i = 0, j = 0 ;
+		while(i < _keys.size() || j < entries.size()){
+			// existing entries first among equal keys
+			if(j == entries.size() || (i < _keys.size() && !less(entries[j].first, _keys[i]))){
+				keys.push_back(_keys[i]) ;
+				values.push_back(std::move(_values[i])) ;
+				++i ;
+			}
+			else {
+				keys.push_back(entries[j].first) ;
+				values.push_back(std::move(entries[j].second)) ;
+				++j ;
+			}
+		}
+		_keys.swap(keys) ;
+		_values.swap(values) ;
+	}
+
+	/// @brief remove the entries whose key is in [lo, hi]
+	/// @param lo lower bound of the keys
+	/// @param hi upper bound of the keys
+	void erase(const Ratio<T>& lo, const Ratio<T>& hi)
+	{
+		const std::pair<std::size_t, std::size_t> ranks = range(lo, hi) ;
+		_keys.erase(_keys.begin() + ranks.first, _keys.begin() + ranks.second) ;
+		_values.erase(_values.begin() + ranks.first, _values.begin() + ranks.second) ;
+	}
+};
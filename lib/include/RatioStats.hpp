@@ -0,0 +1,194 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @class RatioStats
+/// @brief one pass exact statistics (count, sum, mean, variance, min, max) over a stream of ratios.
+/// The sum and the sum of squares are kept as numerators over a common denominator D (and D^2) in the wide type,
+/// so a sample whose denominator divides D is added with integer operations only, without gcd.
+/// D grows (by lcm) only when a new denominator appears. Partial states of parallel streams can be merged.
+/// Every operation on the sums is checked : std::overflow_error is thrown when they no longer fit in the wide type.
+/// @tparam T can be : int, long int
+template<class T>
+class RatioStats {
+
+private :
+	/// @brief wide integer type of the sums
+	using W = wider_t<T> ;
+
+	/// @brief number of samples
+	std::size_t _count ;
+	/// @brief common denominator of the samples
+	W _den ;
+	/// @brief sum of the samples, over _den
+	W _sum ;
+	/// @brief sum of the squares of the samples, over _den^2
+	W _sum_squares ;
+	/// @brief smallest sample
+	Ratio<T> _min ;
+	/// @brief largest sample
+	Ratio<T> _max ;
+	/// @brief last denominator seen and its factor to _den, to skip the division for runs of the same denominator
+	T _last_den ;
+	W _last_scale ;
+
+	/// @brief throw std::overflow_error if an operation overflowed
+	static void check(const bool overflow)
+	{
+		if(overflow) throw std::overflow_error("RatioStats: the sums do not fit in the wide integer type") ;
+	}
+
+	/// @brief a + b, throws std::overflow_error if it does not fit in W
+	static W add(const W a, const W b)
+	{
+		bool overflow = false ;
+		const W result = overflow::detail::checked_add(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief a - b, throws std::overflow_error if it does not fit in W
+	static W sub(const W a, const W b)
+	{
+		bool overflow = false ;
+		const W result = overflow::detail::checked_sub(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief a * b, throws std::overflow_error if it does not fit in W
+	static W mul(const W a, const W b)
+	{
+		bool overflow = false ;
+		const W result = overflow::detail::checked_mul(a, b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief irreducible num / (product of the factors) : each factor is divided by its gcd with the numerator before the product,
+	/// so the denominator only overflows if the result itself does not fit in T
+	/// @return the quotient, throws std::overflow_error if it does not fit in T
+	static Ratio<T> quotient(W num, const std::initializer_list<W> factors)
+	{
+		W den = 1 ;
+		for(W factor : factors){
+			const W pgcd = ratio_gcd(num, factor) ;
+			num /= pgcd ;
+			factor /= pgcd ;
+			den = mul(den, factor) ;
+		}
+		if(num > static_cast<W>(std::numeric_limits<T>::max()) || num < static_cast<W>(std::numeric_limits<T>::min())
+		|| den > static_cast<W>(std::numeric_limits<T>::max())){
+			throw std::overflow_error("RatioStats: the result does not fit in the integer type") ;
+		}
+		return Ratio<T>(static_cast<T>(num), static_cast<T>(den), reduced_tag) ;
+	}
+
+	/// @brief multiply the common denominator by factor
+	void rescale(const W factor)
+	{
+		_den = mul(_den, factor) ;
+		_sum = mul(_sum, factor) ;
+		_sum_squares = mul(_sum_squares, mul(factor, factor)) ;
+		_last_den = 0 ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor, no sample
+	constexpr RatioStats()
+	noexcept : _count(0), _den(1), _sum(0), _sum_squares(0), _min(), _max(), _last_den(0), _last_scale(0) {}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief add a sample, throws std::overflow_error if the sums no longer fit in the wide type
+	/// @param r the sample, with a non null denominator
+	void add(const Ratio<T>& r)
+	{
+		assert( (r.get_denominator() != 0) && "error: infinite sample");
+		const T den = r.get_denominator() ;
+		if(den != _last_den){
+			if(_den % den != 0){
+				// new denominator : D becomes lcm(D, den)
+				rescale(static_cast<W>(den) / ratio_gcd(_den, static_cast<W>(den))) ;
+			}
+			_last_den = den ;
+			_last_scale = _den / den ;
+		}
+
+		const W x = mul(static_cast<W>(r.get_numerator()), _last_scale) ;
+		_sum = add(_sum, x) ;
+		_sum_squares = add(_sum_squares, mul(x, x)) ;
+
+		if(_count == 0 || Ratio<T>::compare(r, _min) < 0) _min = r ;
+		if(_count == 0 || Ratio<T>::compare(r, _max) > 0) _max = r ;
+		++_count ;
+	}
+
+	/// @brief merge the samples of another accumulator, e.g. the partial state of another thread
+	/// @param other the accumulator to merge, throws std::overflow_error if the sums no longer fit in the wide type
+	void merge(const RatioStats& other)
+	{
+		if(other._count == 0) return ;
+		RatioStats tmp = other ;
+		const W pgcd = ratio_gcd(_den, tmp._den) ;
+		rescale(tmp._den / pgcd) ;
+		tmp.rescale(_den / tmp._den) ;
+
+		_sum = add(_sum, tmp._sum) ;
+		_sum_squares = add(_sum_squares, tmp._sum_squares) ;
+		if(_count == 0 || Ratio<T>::compare(tmp._min, _min) < 0) _min = tmp._min ;
+		if(_count == 0 || Ratio<T>::compare(tmp._max, _max) > 0) _max = tmp._max ;
+		_count += tmp._count ;
+	}
+
+	/// @brief number of samples
+	constexpr std::size_t count() const noexcept{ return _count ; }
+
+	/// @brief smallest sample
+	constexpr Ratio<T> min() const noexcept{ return _min ; }
+
+	/// @brief largest sample
+	constexpr Ratio<T> max() const noexcept{ return _max ; }
+
+	/// @brief exact sum of the samples, throws std::overflow_error if it does not fit in T
+	Ratio<T> sum() const
+	{
+		return quotient(_sum, {_den}) ;
+	}
+
+	/// @brief exact mean of the samples, throws std::overflow_error if it does not fit in T
+	Ratio<T> mean() const
+	{
+		assert( (_count > 0) && "error: mean of no sample");
+		return quotient(_sum, {_den, static_cast<W>(_count)}) ;
+	}
+
+	/// @brief exact population variance of the samples : (n*sum(x^2) - sum(x)^2) / (n^2 D^2),
+	/// throws std::overflow_error if it does not fit in T
+	Ratio<T> variance() const
+	{
+		assert( (_count > 0) && "error: variance of no sample");
+		const W n = static_cast<W>(_count) ;
+		return quotient(sub(mul(n, _sum_squares), mul(_sum, _sum)), {n, n, _den, _den}) ;
+	}
+
+	/// @brief exact sample variance of the samples : (n*sum(x^2) - sum(x)^2) / (n*(n-1) D^2),
+	/// throws std::overflow_error if it does not fit in T
+	Ratio<T> sample_variance() const
+	{
+		assert( (_count > 1) && "error: sample variance of less than 2 samples");
+		const W n = static_cast<W>(_count) ;
+		return quotient(sub(mul(n, _sum_squares), mul(_sum, _sum)), {n, n - 1, _den, _den}) ;
+	}
+};
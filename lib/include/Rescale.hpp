@@ -0,0 +1,195 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+#include "Ratio.hpp"
+#include "Rounding.hpp"
+
+#if !defined(__SIZEOF_INT128__)
+#error "Rescale.hpp requires a compiler with 128 bits integers"
+#endif
+
+
+
+namespace rescale_detail {
+
+	/// @brief the factor from/to = num/den, irreducible, as a magnitude and a sign
+	struct Factor {
+		std::uint64_t num ;
+		std::uint64_t den ;
+		bool negative ;
+	};
+
+	/// @brief from/to reduced with one gcd, computed in 128 bits
+	/// @return the factor, throws std::overflow_error if the reduced factor does not fit in 64 bits
+	template<class T, class OverflowPolicy>
+	constexpr Factor factor(const Ratio<T, OverflowPolicy>& from, const Ratio<T, OverflowPolicy>& to)
+	{
+		assert( (from.get_denominator() != 0 && to.get_denominator() != 0 && to.get_numerator() != 0) && "error: the time bases must be finite and the target not null");
+		ratio_int128 num = static_cast<ratio_int128>(from.get_numerator()) * to.get_denominator() ;
+		ratio_int128 den = static_cast<ratio_int128>(from.get_denominator()) * to.get_numerator() ;
+		const bool negative = (num < 0) != (den < 0) ;
+		ratio_uint128 n = (num < 0) ? static_cast<ratio_uint128>(0) - static_cast<ratio_uint128>(num) : static_cast<ratio_uint128>(num) ;
+		ratio_uint128 d = (den < 0) ? static_cast<ratio_uint128>(0) - static_cast<ratio_uint128>(den) : static_cast<ratio_uint128>(den) ;
+		ratio_uint128 a = n, b = d ;
+		while(b != 0){
+			const ratio_uint128 c = a % b ;
+			a = b ;
+			b = c ;
+		}
+		if(a > 1){
+			n /= a ;
+			d /= a ;
+		}
+		if(n > std::numeric_limits<std::uint64_t>::max() || d > std::numeric_limits<std::uint64_t>::max()){
+			throw std::overflow_error("rescale: the reduced factor from/to does not fit in 64 bits") ;
+		}
+		return Factor{static_cast<std::uint64_t>(n), static_cast<std::uint64_t>(d), negative && n != 0} ;
+	}
+
+	/// @brief |ts|
+	constexpr std::uint64_t magnitude(const std::int64_t ts) noexcept{ return (ts < 0) ? std::uint64_t(0) - static_cast<std::uint64_t>(ts) : static_cast<std::uint64_t>(ts) ; }
+
+	/// @brief throw std::overflow_error for a rescaled timestamp out of the 64 bits range
+	[[noreturn]] inline void out_of_range()
+	{
+		throw std::overflow_error("rescale: the rescaled timestamp does not fit in 64 bits") ;
+	}
+
+	/// @brief the signed timestamp of magnitude q, throws std::overflow_error if it does not fit in 64 bits
+	constexpr std::int64_t signed_result(const ratio_uint128 q, const bool negative)
+	{
+		if(q > static_cast<ratio_uint128>(std::numeric_limits<std::int64_t>::max()) + (negative ? 1 : 0)) out_of_range() ;
+		const std::uint64_t magnitude = static_cast<std::uint64_t>(q) ;
+		return negative ? static_cast<std::int64_t>(std::uint64_t(0) - magnitude) : static_cast<std::int64_t>(magnitude) ;
+	}
+
+}
+
+
+/// @brief convert a timestamp from one time base to another : ts * from / to, rounded.
+/// The product is computed exactly in 128 bits, after reducing from/to with one gcd.
+/// @param ts the timestamp, in units of from
+/// @param from time base of ts (e.g. 1/90000)
+/// @param to target time base (e.g. 1001/30000)
+/// @param mode rounding mode of the result
+/// @return the timestamp in units of to, throws std::overflow_error if it or the reduced factor does not fit in 64 bits
+template<class T, class OverflowPolicy>
+constexpr std::int64_t rescale(const std::int64_t ts, const Ratio<T, OverflowPolicy>& from, const Ratio<T, OverflowPolicy>& to, const Rounding mode)
+{
+	const rescale_detail::Factor f = rescale_detail::factor(from, to) ;
+	const ratio_uint128 x = static_cast<ratio_uint128>(rescale_detail::magnitude(ts)) * f.num ;
+	const ratio_uint128 q = x / f.den ;
+	const std::uint64_t r = static_cast<std::uint64_t>(x % f.den) ;
+	const bool negative = (ts < 0) != f.negative ;
+	const ratio_uint128 rounded = q + ((r != 0 && rounds_away(r, f.den, negative, (q & 1) != 0, mode)) ? 1 : 0) ;
+	return rescale_detail::signed_result(rounded, negative) ;
+}
+
+
+/// @class Rescaler
+/// @brief conversion of many timestamps between two fixed time bases. The factor num/den is reduced once, and the division
+/// by the invariant den is replaced by a multiplication by its precomputed reciprocal (Moller-Granlund division 2/1),
+/// so each timestamp costs a few multiplications, without gcd and without hardware division.
+class Rescaler {
+
+private :
+	/// @brief the reduced factor
+	rescale_detail::Factor _factor ;
+	/// @brief rounding mode
+	Rounding _mode ;
+	/// @brief shift normalizing den (highest bit set)
+	unsigned _shift ;
+	/// @brief den << _shift
+	std::uint64_t _normalized ;
+	/// @brief reciprocal of the normalized divisor : floor((2^128 - 1) / _normalized) - 2^64
+	std::uint64_t _reciprocal ;
+
+	/// @brief quotient and remainder of (u1, u0) by the normalized divisor, u1 being lower than it
+	constexpr std::uint64_t divide(const std::uint64_t u1, const std::uint64_t u0, std::uint64_t& r) const
+	noexcept{
+		const ratio_uint128 p = static_cast<ratio_uint128>(_reciprocal) * u1 + ((static_cast<ratio_uint128>(u1 + 1) << 64) | u0) ;
+		std::uint64_t q1 = static_cast<std::uint64_t>(p >> 64) ;
+		const std::uint64_t q0 = static_cast<std::uint64_t>(p) ;
+		r = u0 - q1 * _normalized ;
+		if(r > q0){
+			--q1 ;
+			r += _normalized ;
+		}
+		if(r >= _normalized){
+			++q1 ;
+			r -= _normalized ;
+		}
+		return q1 ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor
+	/// @param from time base of the timestamps
+	/// @param to target time base
+	/// @param mode rounding mode of the results
+	/// @throw std::overflow_error if the reduced factor from/to does not fit in 64 bits
+	template<class T, class OverflowPolicy>
+	constexpr Rescaler(const Ratio<T, OverflowPolicy>& from, const Ratio<T, OverflowPolicy>& to, const Rounding mode)
+	: _factor(rescale_detail::factor(from, to)), _mode(mode), _shift(0), _normalized(0), _reciprocal(0) {
+		_shift = static_cast<unsigned>(__builtin_clzll(_factor.den)) ;
+		_normalized = _factor.den << _shift ;
+		_reciprocal = static_cast<std::uint64_t>(~static_cast<ratio_uint128>(0) / _normalized - (static_cast<ratio_uint128>(1) << 64)) ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief numerator of the reduced factor from/to (absolute value)
+	constexpr std::uint64_t numerator() const noexcept{ return _factor.num ; }
+
+	/// @brief denominator of the reduced factor from/to
+	constexpr std::uint64_t denominator() const noexcept{ return _factor.den ; }
+
+	/// @brief rescale one timestamp, same result as rescale(ts, from, to, mode)
+	/// @throw std::overflow_error if the result does not fit in 64 bits
+	constexpr std::int64_t operator() (const std::int64_t ts) const
+	{
+		const ratio_uint128 x = static_cast<ratio_uint128>(rescale_detail::magnitude(ts)) * _factor.num ;
+		// the division 2/1 needs a quotient of 64 bits
+		if(static_cast<std::uint64_t>(x >> 64) >= _factor.den) rescale_detail::out_of_range() ;
+		// normalize the dividend like the divisor, the remainder comes back with the inverse shift
+		const ratio_uint128 u = x << _shift ;
+		std::uint64_t r = 0 ;
+		const std::uint64_t q = divide(static_cast<std::uint64_t>(u >> 64), static_cast<std::uint64_t>(u), r) ;
+		r >>= _shift ;
+		const bool negative = (ts < 0) != _factor.negative ;
+		const ratio_uint128 rounded = static_cast<ratio_uint128>(q) + ((r != 0 && rounds_away(r, _factor.den, negative, (q & 1) != 0, _mode)) ? 1 : 0) ;
+		return rescale_detail::signed_result(rounded, negative) ;
+	}
+
+	/// @brief rescale an array of timestamps
+	/// @param in the timestamps
+	/// @param count number of timestamps
+	/// @param out the rescaled timestamps (may be in), throws std::overflow_error at the first one out of the 64 bits range
+	void operator() (const std::int64_t* in, const std::size_t count, std::int64_t* out) const
+	{
+		for(std::size_t i = 0; i < count; ++i) out[i] = (*this)(in[i]) ;
+	}
+};
+
+
+/// @brief rescale an array of timestamps (see Rescaler)
+/// @param in the timestamps
+/// @param count number of timestamps
+/// @param out the rescaled timestamps (may be in)
+/// @param from time base of the timestamps
+/// @param to target time base
+/// @param mode rounding mode of the results
+/// @throw std::overflow_error if the reduced factor or a rescaled timestamp does not fit in 64 bits
+template<class T, class OverflowPolicy>
+void rescale(const std::int64_t* in, const std::size_t count, std::int64_t* out, const Ratio<T, OverflowPolicy>& from, const Ratio<T, OverflowPolicy>& to, const Rounding mode)
+{
+	Rescaler(from, to, mode)(in, count, out) ;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <type_traits>
+#include <cassert>
+
+
+
+/// @brief how a quotient which is not an integer is rounded
+enum class Rounding {
+	toward_zero,    ///< truncation, like the integer division
+	down,           ///< toward minus infinity (floor)
+	up,             ///< toward plus infinity (ceil)
+	nearest,        ///< to the nearest integer, ties away from zero
+	half_even       ///< to the nearest integer, ties to the even one (banker's rounding)
+};
+
+
+/// @brief whether a quotient q < |n/d| < q+1 is rounded away from zero (to q+1) or toward zero (to q)
+/// @param abs_r absolute value of the remainder, not null
+/// @param abs_d absolute value of the divisor
+/// @param negative true if the quotient is negative
+/// @param odd true if q is odd (for half_even)
+/// @param mode rounding mode
+template<class U>
+constexpr bool rounds_away(const U abs_r, const U abs_d, const bool negative, const bool odd, const Rounding mode)
+noexcept{
+	switch(mode){
+		case Rounding::toward_zero :
+			return false ;
+		case Rounding::down :
+			return negative ;
+		case Rounding::up :
+			return !negative ;
+		case Rounding::nearest :
+			// |r| >= |d|/2, written to avoid overflowing 2|r|
+			return abs_r >= abs_d - abs_r ;
+		case Rounding::half_even :
+			if(abs_r != abs_d - abs_r) return abs_r > abs_d - abs_r ;
+			return odd ;
+	}
+	return false ;
+}
+
+
+/// @brief integer division n/d rounded according to mode, without overflow for any representable quotient
+/// @param n dividend
+/// @param d divisor, not null
+/// @param mode rounding mode
+/// @return the rounded quotient
+template<class T>
+constexpr T rounded_division(const T n, const T d, const Rounding mode)
+noexcept{
+	assert( (d != 0) && "error: division by zero");
+	const T q = n / d ;
+	const T r = n % d ;
+	if(r == 0) return q ;
+
+	// the exact quotient is between q and q+away, away being the direction opposite to zero
+	bool negative = false ;
+	if constexpr (std::is_signed<T>::value) negative = (r < 0) != (d < 0) ;
+	const T away = negative ? static_cast<T>(-1) : static_cast<T>(1) ;
+
+	using U = typename std::make_unsigned<T>::type ;
+	U abs_r = static_cast<U>(r) ;
+	U abs_d = static_cast<U>(d) ;
+	if constexpr (std::is_signed<T>::value){
+		if(r < 0) abs_r = static_cast<U>(0) - abs_r ;
+		if(d < 0) abs_d = static_cast<U>(0) - abs_d ;
+	}
+
+	return rounds_away(abs_r, abs_d, negative, q % 2 != 0, mode) ? q + away : q ;
+}
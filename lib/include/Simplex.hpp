@@ -0,0 +1,529 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+
+
+
+/// @brief rule choosing the entering variable of a simplex pivot
+enum class PivotRule {
+	bland,           ///< smallest index with a negative reduced cost, never cycles
+	dantzig,         ///< most negative reduced cost
+	steepest_edge    ///< largest decrease of the objective per unit of length of the edge
+};
+
+/// @brief outcome of a simplex resolution
+enum class SimplexStatus {
+	optimal,
+	infeasible,
+	unbounded
+};
+
+/// @brief parameters of a simplex resolution
+struct SimplexOptions {
+	/// @brief rule choosing the entering variable
+	PivotRule rule = PivotRule::bland ;
+	/// @brief pivot on an integer tableau with a common divisor (Bareiss) instead of a tableau of reduced ratios
+	bool fraction_free = false ;
+	/// @brief number of threads searching the entering column (dantzig and steepest edge rules).
+	/// A pivot is searched by the calling thread alone when it has less than Simplex::min_work_per_thread cells per thread to read.
+	std::size_t nb_threads = 1 ;
+	/// @brief warm start : one basic variable per constraint, usually the basis of a previous result.
+	/// Variables 0..n-1 are the unknowns, n..n+m-1 the slacks of the constraints. Ignored if singular or infeasible.
+	std::vector<std::size_t> warm_basis ;
+};
+
+
+/// @class Simplex
+/// @brief exact simplex solver of the linear program : maximize c.x subject to A.x <= b and x >= 0.
+/// The dense tableau is stored in one contiguous row-major array, of reduced ratios or, with fraction-free pivoting,
+/// of integers over a common divisor. A negative b is handled by a first phase with one artificial variable.
+/// The default overflow policy computes the products in the wider integer type, as the fraction-free pivots do.
+/// A revised simplex is not implemented.
+/// Nothing bounds the growth of the entries over the pivots : with the default policy or fraction-free pivoting, an entry which
+/// no longer fits in T throws std::overflow_error.
+/// @tparam T can be : int, long int
+/// @tparam OverflowPolicy overflow policy of the ratios of the tableau (default : overflow::Promote)
+template<class T, class OverflowPolicy = overflow::Promote>
+class Simplex {
+
+public :
+	/// @brief type of the coefficients
+	using ratio_type = Ratio<T, OverflowPolicy> ;
+
+	/// @brief minimum number of tableau cells read per thread for a parallel search of the entering column :
+	/// the threads are started at each pivot, below this work their creation costs more than the search
+	static constexpr std::size_t min_work_per_thread = 4096 ;
+
+	/// @brief result of a resolution
+	struct Result {
+		/// @brief optimal, infeasible or unbounded
+		SimplexStatus status ;
+		/// @brief optimal value of the objective
+		ratio_type value ;
+		/// @brief optimal values of the n unknowns
+		std::vector<ratio_type> solution ;
+		/// @brief basic variable of each constraint, to warm start a close problem
+		std::vector<std::size_t> basis ;
+		/// @brief number of pivots
+		std::size_t nb_pivots ;
+	};
+
+private :
+
+	/// @brief number of constraints and of unknowns
+	std::size_t _m, _n ;
+	/// @brief number of columns : n unknowns, m slacks, 1 artificial, right-hand side
+	std::size_t _width ;
+	/// @brief objective coefficients
+	std::vector<ratio_type> _costs ;
+	/// @brief initial tableau, (m+1) rows, the last one being the objective
+	std::vector<ratio_type> _initial ;
+
+	/// @brief working state of a resolution : the cells are reduced ratios, a pivot divides the pivot row
+	struct Tableau {
+		std::vector<ratio_type> cells ;
+		std::vector<std::size_t> basis ;
+		std::size_t m, width ;
+		std::size_t nb_pivots ;
+
+		/// @brief the initial tableau of the program, the slacks being basic
+		explicit Tableau(const Simplex& lp)
+		: cells(lp._initial), basis(lp._m), m(lp._m), width(lp._width), nb_pivots(0) {
+			for(std::size_t i = 0; i < m; ++i) basis[i] = lp._n + i ;
+		}
+
+		ratio_type& at(const std::size_t i, const std::size_t j) noexcept{ return cells[i*width + j] ; }
+		const ratio_type& at(const std::size_t i, const std::size_t j) const noexcept{ return cells[i*width + j] ; }
+
+		/// @brief sign of the cell (i, j)
+		int sign(const std::size_t i, const std::size_t j) const noexcept{ return (at(i, j).get_numerator() > 0) - (at(i, j).get_numerator() < 0) ; }
+		/// @brief value of the cell (i, j)
+		ratio_type value(const std::size_t i, const std::size_t j) const noexcept{ return at(i, j) ; }
+		/// @brief true if the cell (i, j) is less than the cell (k, l)
+		bool less(const std::size_t i, const std::size_t j, const std::size_t k, const std::size_t l) const{ return at(i, j) < at(k, l) ; }
+		/// @brief cell (i, k) divided by the cell (i, j) of the same row
+		ratio_type quotient(const std::size_t i, const std::size_t k, const std::size_t j) const{ return at(i, k) / at(i, j) ; }
+		/// @brief value of the objective
+		ratio_type objective() const noexcept{ return at(m, width - 1) ; }
+
+		/// @brief set the column j of the constraints to -1
+		void set_negative_column(const std::size_t j) noexcept{
+			for(std::size_t i = 0; i < m; ++i) at(i, j) = -ratio_type::one() ;
+		}
+
+		/// @brief pivot on the cell (r, j) : the variable j enters the basis in place of the basic variable of row r
+		void pivot(const std::size_t r, const std::size_t j)
+		{
+			const ratio_type pivot_value = at(r, j) ;
+			for(std::size_t k = 0; k < width; ++k){
+				if(at(r, k).get_numerator() != 0) at(r, k) /= pivot_value ;
+			}
+			for(std::size_t i = 0; i <= m; ++i){
+				if(i == r) continue ;
+				const ratio_type factor = at(i, j) ;
+				if(factor.get_numerator() == 0) continue ;
+				for(std::size_t k = 0; k < width; ++k){
+					if(at(r, k).get_numerator() != 0) at(i, k) -= factor * at(r, k) ;
+				}
+			}
+			basis[r] = j ;
+			++nb_pivots ;
+		}
+
+		/// @brief replace the objective row by maximize costs.x, expressed with the non basic variables
+		void set_objective(const std::vector<ratio_type>& costs)
+		{
+			for(std::size_t k = 0; k < width; ++k) at(m, k) = (k < costs.size()) ? -costs[k] : ratio_type::zero() ;
+			for(std::size_t i = 0; i < m; ++i){
+				const ratio_type factor = at(m, basis[i]) ;
+				if(factor.get_numerator() == 0) continue ;
+				for(std::size_t k = 0; k < width; ++k){
+					if(at(i, k).get_numerator() != 0) at(m, k) -= factor * at(i, k) ;
+				}
+			}
+		}
+	};
+
+	/// @brief working state of a fraction-free resolution : the cells are integers over a common positive divisor,
+	/// the determinant of the current basis. A pivot is the integer update of Bareiss, whose divisions are exact :
+	/// no gcd is computed, and the entries grow like the minors of the constraints instead of their products.
+	/// Each constraint is first multiplied by the lcm of its denominators (its slack being rescaled),
+	/// the objective by the lcm of the denominators of the costs.
+	struct IntegerTableau {
+		std::vector<T> cells ;
+		std::vector<std::size_t> basis ;
+		std::size_t m, width ;
+		std::size_t nb_pivots ;
+		/// @brief common divisor of the cells, positive
+		T divisor ;
+		/// @brief positive factor of the objective row
+		T objective_scale ;
+
+		/// @brief the initial tableau of the program, the slacks being basic
+		explicit IntegerTableau(const Simplex& lp)
+		: cells((lp._m + 1) * lp._width, 0), basis(lp._m), m(lp._m), width(lp._width), nb_pivots(0), divisor(1), objective_scale(1) {
+			for(std::size_t i = 0; i < m; ++i){
+				basis[i] = lp._n + i ;
+				T scale = 1 ;
+				for(std::size_t k = 0; k < width; ++k) scale = lcm(scale, lp._initial[i*width + k].get_denominator()) ;
+				for(std::size_t k = 0; k < width; ++k) at(i, k) = scaled(lp._initial[i*width + k], scale) ;
+				at(i, lp._n + i) = 1 ;
+			}
+			set_objective(lp._costs) ;
+		}
+
+		T& at(const std::size_t i, const std::size_t j) noexcept{ return cells[i*width + j] ; }
+		const T& at(const std::size_t i, const std::size_t j) const noexcept{ return cells[i*width + j] ; }
+
+		int sign(const std::size_t i, const std::size_t j) const noexcept{ return (at(i, j) > 0) - (at(i, j) < 0) ; }
+		ratio_type value(const std::size_t i, const std::size_t j) const{ return ratio_type(at(i, j), divisor) ; }
+		bool less(const std::size_t i, const std::size_t j, const std::size_t k, const std::size_t l) const noexcept{ return at(i, j) < at(k, l) ; }
+		ratio_type quotient(const std::size_t i, const std::size_t k, const std::size_t j) const{ return ratio_type(at(i, k), at(i, j)) ; }
+		ratio_type objective() const{ return value(m, width - 1) / ratio_type(objective_scale) ; }
+
+		void set_negative_column(const std::size_t j){
+			for(std::size_t i = 0; i < m; ++i) at(i, j) = narrow(-static_cast<wide_type>(divisor)) ;
+		}
+
+		/// @brief pivot on the cell (r, j) : every other row becomes (row*pivot - cell*pivot row) / divisor, the pivot being the new divisor
+		void pivot(const std::size_t r, const std::size_t j)
+		{
+			const wide_type p = at(r, j) ;
+			for(std::size_t i = 0; i <= m; ++i){
+				if(i == r) continue ;
+				const wide_type factor = at(i, j) ;
+				if(factor == 0 && p == divisor) continue ;
+				for(std::size_t k = 0; k < width; ++k){
+					bool overflow = false ;
+					const wide_type scaled_cell = overflow::detail::checked_mul(static_cast<wide_type>(at(i, k)), p, overflow) ;
+					const wide_type scaled_pivot_row = overflow::detail::checked_mul(factor, static_cast<wide_type>(at(r, k)), overflow) ;
+					const wide_type numerator = overflow::detail::checked_sub(scaled_cell, scaled_pivot_row, overflow) ;
+					check(overflow) ;
+					at(i, k) = narrow(numerator / divisor) ;
+				}
+			}
+			// keep the divisor positive
+			if(p < 0){
+				for(T& cell : cells) cell = narrow(-static_cast<wide_type>(cell)) ;
+			}
+			divisor = narrow(p < 0 ? -p : p) ;
+			basis[r] = j ;
+			++nb_pivots ;
+		}
+
+		/// @brief replace the objective row by maximize costs.x, expressed with the non basic variables :
+		/// -costs*divisor + the sum of the constraint rows weighted by the costs of their basic variables
+		void set_objective(const std::vector<ratio_type>& costs)
+		{
+			objective_scale = 1 ;
+			for(const ratio_type& cost : costs) objective_scale = lcm(objective_scale, cost.get_denominator()) ;
+			std::vector<T> integer_costs(width, 0) ;
+			for(std::size_t k = 0; k < costs.size(); ++k) integer_costs[k] = scaled(costs[k], objective_scale) ;
+
+			for(std::size_t k = 0; k < width; ++k){
+				bool overflow = false ;
+				wide_type cell = overflow::detail::checked_mul(-static_cast<wide_type>(integer_costs[k]), static_cast<wide_type>(divisor), overflow) ;
+				for(std::size_t i = 0; i < m; ++i){
+					const wide_type term = overflow::detail::checked_mul(static_cast<wide_type>(integer_costs[basis[i]]), static_cast<wide_type>(at(i, k)), overflow) ;
+					cell = overflow::detail::checked_add(cell, term, overflow) ;
+				}
+				check(overflow) ;
+				at(m, k) = narrow(cell) ;
+			}
+		}
+	};
+
+	/// @brief integer type of the intermediate products of the fraction-free pivots
+	using wide_type = wider_t<T> ;
+
+	/// @brief throw std::overflow_error if an entry of the integer tableau overflowed
+	static void check(const bool overflow)
+	{
+		if(overflow) throw std::overflow_error("Simplex: an entry of the integer tableau does not fit in the integer type") ;
+	}
+
+	/// @brief x back in T, throws std::overflow_error if it does not fit
+	static T narrow(const wide_type x)
+	{
+		check(x > static_cast<wide_type>(std::numeric_limits<T>::max()) || x < static_cast<wide_type>(std::numeric_limits<T>::min())) ;
+		return static_cast<T>(x) ;
+	}
+
+	/// @brief least common multiple of 2 positive integers, throws std::overflow_error if it does not fit in T
+	static T lcm(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_mul(a / ratio_gcd(a, b), b, overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief r times scale, a multiple of its denominator
+	static T scaled(const ratio_type& r, const T scale)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_mul(r.get_numerator(), scale / r.get_denominator(), overflow) ;
+		check(overflow) ;
+		return result ;
+	}
+
+	/// @brief tableau cells read to evaluate one column with the rule
+	std::size_t work_per_column(const PivotRule rule) const noexcept{ return (rule == PivotRule::steepest_edge) ? _m + 1 : 1 ; }
+
+	std::size_t artificial() const noexcept{ return _n + _m ; }
+	std::size_t rhs() const noexcept{ return _n + _m + 1 ; }
+
+	template<class InputPolicy>
+	static ratio_type convert(const Ratio<T, InputPolicy>& r) noexcept{ return ratio_type(r.get_numerator(), r.get_denominator(), reduced_tag) ; }
+
+	/// @brief steepest edge measure of column j : reduced cost^2 / (1 + |column|^2), one reduced ratio compared with Ratio::compare,
+	/// so that 2 measures are compared without multiplying their numerators and denominators in T
+	template<class Tab>
+	ratio_type steepness(const Tab& t, const std::size_t j) const
+	{
+		ratio_type norm = ratio_type::one() ;
+		for(std::size_t i = 0; i < _m; ++i){
+			if(t.sign(i, j) == 0) continue ;
+			const ratio_type x = t.value(i, j) ;
+			norm += x * x ;
+		}
+		const ratio_type cost = t.value(_m, j) ;
+		return cost * cost / norm ;
+	}
+
+	/// @brief best entering column among [first, last) for the dantzig or steepest edge rule, or _width if none
+	template<class Tab>
+	std::size_t best_column(const Tab& t, const std::size_t first, const std::size_t last, const PivotRule rule) const
+	{
+		std::size_t best = _width ;
+		ratio_type best_steepness ;
+		for(std::size_t j = first; j < last; ++j){
+			if(t.sign(_m, j) >= 0) continue ;
+			if(rule == PivotRule::dantzig){
+				if(best == _width || t.less(_m, j, _m, best)) best = j ;
+			}
+			else {
+				const ratio_type s = steepness(t, j) ;
+				if(best == _width || ratio_type::compare(s, best_steepness) > 0){
+					best = j ;
+					best_steepness = s ;
+				}
+			}
+		}
+		return best ;
+	}
+
+	/// @brief entering column, or _width if the basis is optimal
+	template<class Tab>
+	std::size_t entering(const Tab& t, const PivotRule rule, const std::size_t nb_columns, const std::size_t nb_threads) const
+	{
+		if(rule == PivotRule::bland){
+			for(std::size_t j = 0; j < nb_columns; ++j){
+				if(t.sign(_m, j) < 0) return j ;
+			}
+			return _width ;
+		}
+		if(nb_threads <= 1 || nb_columns * work_per_column(rule) < min_work_per_thread * nb_threads) return best_column(t, 0, nb_columns, rule) ;
+
+		// each thread searches a slice of the columns, then the best candidates of the slices are compared
+		std::vector<std::size_t> candidates(nb_threads, _width) ;
+		std::vector<std::exception_ptr> errors(nb_threads) ;
+		std::vector<std::thread> threads ;
+		const std::size_t slice = (nb_columns + nb_threads - 1) / nb_threads ;
+		for(std::size_t k = 0; k < nb_threads; ++k){
+			threads.emplace_back([this, &t, &candidates, &errors, k, slice, nb_columns, rule](){
+				try{
+					candidates[k] = best_column(t, std::min(k*slice, nb_columns), std::min((k+1)*slice, nb_columns), rule) ;
+				}
+				catch(...){
+					errors[k] = std::current_exception() ;
+				}
+			}) ;
+		}
+		for(std::thread& thread : threads) thread.join() ;
+		// an overflow of the ratios in a slice is thrown to the caller
+		for(const std::exception_ptr& error : errors){
+			if(error) std::rethrow_exception(error) ;
+		}
+
+		std::size_t best = _width ;
+		for(const std::size_t j : candidates){
+			if(j == _width) continue ;
+			if(best == _width) best = j ;
+			else if(rule == PivotRule::dantzig){
+				if(t.less(_m, j, _m, best)) best = j ;
+			}
+			else {
+				if(ratio_type::compare(steepness(t, j), steepness(t, best)) > 0) best = j ;
+			}
+		}
+		return best ;
+	}
+
+	/// @brief leaving row by the minimum ratio test (ties : smallest basic variable), or _m if the column is unbounded
+	template<class Tab>
+	std::size_t leaving(const Tab& t, const std::size_t j) const
+	{
+		std::size_t best = _m ;
+		ratio_type best_ratio ;
+		for(std::size_t i = 0; i < _m; ++i){
+			if(t.sign(i, j) <= 0) continue ;
+			const ratio_type q = t.quotient(i, rhs(), j) ;
+			const int order = (best == _m) ? -1 : ratio_type::compare(q, best_ratio) ;
+			if(order < 0 || (order == 0 && t.basis[i] < t.basis[best])){
+				best = i ;
+				best_ratio = q ;
+			}
+		}
+		return best ;
+	}
+
+	/// @brief pivot until the objective row is optimal
+	/// @return false if the problem is unbounded
+	template<class Tab>
+	bool iterate(Tab& t, const SimplexOptions& options, const std::size_t nb_columns) const
+	{
+		// after too many degenerate pivots in a row, switch to the rule of Bland, which cannot cycle
+		const std::size_t max_degenerate = 2*(_m + _n) + 16 ;
+		std::size_t degenerate = 0 ;
+		while(true){
+			const PivotRule rule = (degenerate > max_degenerate) ? PivotRule::bland : options.rule ;
+			const std::size_t j = entering(t, rule, nb_columns, options.nb_threads) ;
+			if(j == _width) return true ;
+			const std::size_t r = leaving(t, j) ;
+			if(r == _m) return false ;
+			degenerate = (t.sign(r, rhs()) == 0) ? degenerate + 1 : 0 ;
+			t.pivot(r, j) ;
+		}
+	}
+
+	/// @brief bring the variables of the warm basis into the basis
+	/// @return false if the warm basis is singular or infeasible
+	template<class Tab>
+	bool warm_start(Tab& t, const std::vector<std::size_t>& wanted) const
+	{
+		if(wanted.size() != _m) return false ;
+		std::vector<bool> is_wanted(_width, false) ;
+		for(const std::size_t j : wanted){
+			if(j >= _n + _m) return false ;
+			is_wanted[j] = true ;
+		}
+		for(const std::size_t j : wanted){
+			if(std::find(t.basis.begin(), t.basis.end(), j) != t.basis.end()) continue ;
+			std::size_t r = 0 ;
+			while(r < _m && (is_wanted[t.basis[r]] || t.sign(r, j) == 0)) ++r ;
+			if(r == _m) return false ;
+			t.pivot(r, j) ;
+		}
+		for(std::size_t i = 0; i < _m; ++i){
+			if(t.sign(i, rhs()) < 0) return false ;
+		}
+		return true ;
+	}
+
+	/// @brief the two phases of the resolution on a tableau type
+	template<class Tab>
+	Result solve(const SimplexOptions& options) const
+	{
+		Tab t(*this) ;
+		if(!options.warm_basis.empty() && !warm_start(t, options.warm_basis)) t = Tab(*this) ;
+
+		Result result{SimplexStatus::optimal, ratio_type::zero(), std::vector<ratio_type>(_n, ratio_type::zero()), {}, 0} ;
+
+		// phase 1 if the basis is infeasible : maximize -x0 with x0 subtracted from every constraint
+		std::size_t most_negative = _m ;
+		for(std::size_t i = 0; i < _m; ++i){
+			if(t.sign(i, rhs()) < 0 && (most_negative == _m || t.less(i, rhs(), most_negative, rhs()))) most_negative = i ;
+		}
+		if(most_negative != _m){
+			t.set_negative_column(artificial()) ;
+			std::vector<ratio_type> phase1(_width - 1, ratio_type::zero()) ;
+			phase1[artificial()] = -ratio_type::one() ;
+			t.set_objective(phase1) ;
+			t.pivot(most_negative, artificial()) ;
+			iterate(t, options, artificial() + 1) ;
+
+			if(t.sign(_m, rhs()) < 0){
+				result.status = SimplexStatus::infeasible ;
+				result.nb_pivots = t.nb_pivots ;
+				return result ;
+			}
+			// x0 is null : take it out of the basis if it is still there
+			for(std::size_t i = 0; i < _m; ++i){
+				if(t.basis[i] != artificial()) continue ;
+				for(std::size_t k = 0; k < artificial(); ++k){
+					if(t.sign(i, k) != 0){
+						t.pivot(i, k) ;
+						break ;
+					}
+				}
+			}
+			t.set_objective(_costs) ;
+		}
+
+		// phase 2, the artificial variable never enters again
+		if(!iterate(t, options, artificial())){
+			result.status = SimplexStatus::unbounded ;
+			result.nb_pivots = t.nb_pivots ;
+			return result ;
+		}
+
+		result.value = t.objective() ;
+		for(std::size_t i = 0; i < _m; ++i){
+			if(t.basis[i] < _n) result.solution[t.basis[i]] = t.value(i, rhs()) ;
+		}
+		result.basis = t.basis ;
+		result.nb_pivots = t.nb_pivots ;
+		return result ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief constructor of the program : maximize c.x subject to A.x <= b and x >= 0
+	/// @param A the m x n matrix of the constraints, one vector per row
+	/// @param b the m right-hand sides
+	/// @param c the n coefficients of the objective
+	template<class InputPolicy>
+	Simplex(const std::vector<std::vector<Ratio<T, InputPolicy>>>& A, const std::vector<Ratio<T, InputPolicy>>& b, const std::vector<Ratio<T, InputPolicy>>& c)
+	: _m(A.size()), _n(c.size()), _width(c.size() + A.size() + 2), _costs(), _initial() {
+		assert( (b.size() == _m) && "error: one right-hand side per constraint");
+		_costs.reserve(_n) ;
+		for(const Ratio<T, InputPolicy>& x : c) _costs.push_back(convert(x)) ;
+
+		_initial.assign((_m + 1) * _width, ratio_type::zero()) ;
+		for(std::size_t i = 0; i < _m; ++i){
+			assert( (A[i].size() == _n) && "error: one coefficient per unknown");
+			for(std::size_t j = 0; j < _n; ++j) _initial[i*_width + j] = convert(A[i][j]) ;
+			_initial[i*_width + _n + i] = ratio_type::one() ;
+			_initial[i*_width + rhs()] = convert(b[i]) ;
+		}
+		for(std::size_t j = 0; j < _n; ++j) _initial[_m*_width + j] = -_costs[j] ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief solve the program
+	/// @param options pivot rule, fraction-free pivoting, number of threads and warm start
+	/// @return the status, and if optimal the value, the solution and the basis
+	Result maximize(const SimplexOptions& options = SimplexOptions()) const
+	{
+		return options.fraction_free ? solve<IntegerTableau>(options) : solve<Tableau>(options) ;
+	}
+
+	/// @brief number of constraints
+	std::size_t nb_constraints() const noexcept{ return _m ; }
+
+	/// @brief number of unknowns
+	std::size_t nb_unknowns() const noexcept{ return _n ; }
+};
@@ -0,0 +1,438 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "Ratio.hpp"
+#include "Modular.hpp"
+
+
+
+/// @class SparseMatrix
+/// @brief sparse matrix of ratios in compressed sparse rows (CSR), each row over its own common denominator :
+/// a row stores the columns and the integer numerators of its nonzero entries, plus one positive denominator.
+/// The memory and the cost of the operations are proportional to the number of nonzero entries (nnz).
+/// The transpose is the compressed sparse columns (CSC) form of the matrix.
+/// @tparam T can be : int, long int
+template<class T>
+class SparseMatrix {
+
+public :
+	/// @brief an entry given to the constructor
+	struct Triplet {
+		std::size_t row ;
+		std::size_t col ;
+		Ratio<T> value ;
+	};
+
+private :
+	std::size_t _nb_rows ;
+	std::size_t _nb_cols ;
+	/// @brief entries of row i : [_row_start[i], _row_start[i+1]), sorted by column
+	std::vector<std::size_t> _row_start ;
+	/// @brief column of each entry
+	std::vector<std::size_t> _columns ;
+	/// @brief numerator of each entry, over the denominator of its row
+	std::vector<T> _numerators ;
+	/// @brief common denominator of each row, positive
+	std::vector<T> _denominators ;
+
+	/// @brief a*b, throws std::overflow_error if it does not fit in T
+	static T checked_mul(const T a, const T b)
+	{
+		bool overflow = false ;
+		const T result = overflow::detail::checked_mul(a, b, overflow) ;
+		if(overflow) throw std::overflow_error("SparseMatrix: the common denominator of a row does not fit in the integer type") ;
+		return result ;
+	}
+
+	/// @brief exact a + b of 2 entries at the same position, throws std::overflow_error if it does not fit in T
+	static Ratio<T> checked_sum(const Ratio<T>& a, const Ratio<T>& b)
+	{
+		const T pgcd = ratio_gcd(a.get_denominator(), b.get_denominator()) ;
+		bool overflow = false ;
+		const T num = overflow::detail::checked_add(overflow::detail::checked_mul(a.get_numerator(), b.get_denominator() / pgcd, overflow),
+		                                           overflow::detail::checked_mul(b.get_numerator(), a.get_denominator() / pgcd, overflow), overflow) ;
+		const T den = overflow::detail::checked_mul(a.get_denominator() / pgcd, b.get_denominator(), overflow) ;
+		if(overflow) throw std::overflow_error("SparseMatrix: the sum of the entries at the same position does not fit in the integer type") ;
+		return Ratio<T>(num, den) ;
+	}
+
+	/// @brief run f(first, last) on contiguous slices of [0, count), on up to nb_threads threads
+	template<class Function>
+	static void parallel_slices(const std::size_t count, const std::size_t nb_threads, Function f)
+	{
+		const std::size_t nb = std::max<std::size_t>(1, std::min(nb_threads, count / 1024)) ;
+		const std::size_t slice = (count + nb - 1) / std::max<std::size_t>(nb, 1) ;
+		modular::detail::parallel_for(nb, nb, [&](const std::size_t k){
+			f(std::min(k * slice, count), std::min((k + 1) * slice, count)) ;
+		}) ;
+	}
+
+public :
+
+/*------------------- CONSTRUCT0R ---------------------*/
+
+	/// @brief null matrix
+	/// @param nb_rows number of rows
+	/// @param nb_cols number of columns
+	SparseMatrix(const std::size_t nb_rows = 0, const std::size_t nb_cols = 0)
+	: _nb_rows(nb_rows), _nb_cols(nb_cols), _row_start(nb_rows + 1, 0), _columns(), _numerators(), _denominators(nb_rows, 1) {}
+
+	/// @brief matrix built from its entries
+	/// @param nb_rows number of rows
+	/// @param nb_cols number of columns
+	/// @param entries the entries, in any order ; the values at the same position are added, the null values are dropped
+	/// Throws std::overflow_error if the sum of the values at the same position or the common denominator of a row does not fit in T.
+	SparseMatrix(const std::size_t nb_rows, const std::size_t nb_cols, std::vector<Triplet> entries)
+	: SparseMatrix(nb_rows, nb_cols) {
+		std::sort(entries.begin(), entries.end(), [](const Triplet& a, const Triplet& b){ return (a.row != b.row) ? a.row < b.row : a.col < b.col ; }) ;
+
+		// sum of the duplicates, null values dropped
+		std::vector<Triplet> merged ;
+		merged.reserve(entries.size()) ;
+		for(const Triplet& e : entries){
+			assert( (e.row < nb_rows && e.col < nb_cols) && "error: entry out of the matrix");
+			assert( (e.value.get_denominator() != 0) && "error: infinite entry");
+			if(!merged.empty() && merged.back().row == e.row && merged.back().col == e.col) merged.back().value = checked_sum(merged.back().value, e.value) ;
+			else merged.push_back(e) ;
+		}
+		merged.erase(std::remove_if(merged.begin(), merged.end(), [](const Triplet& e){ return e.value.get_numerator() == 0 ; }), merged.end()) ;
+
+		_columns.reserve(merged.size()) ;
+		_numerators.reserve(merged.size()) ;
+		std::size_t k = 0 ;
+		for(std::size_t i = 0; i < nb_rows; ++i){
+			const std::size_t first = k ;
+			T den = 1 ;
+			for(; k < merged.size() && merged[k].row == i; ++k){
+				const T d = merged[k].value.get_denominator() ;
+				den = checked_mul(den / std::gcd(den, d), d) ;
+			}
+			_denominators[i] = den ;
+			for(std::size_t e = first; e < k; ++e){
+				_columns.push_back(merged[e].col) ;
+				_numerators.push_back(checked_mul(merged[e].value.get_numerator(), den / merged[e].value.get_denominator())) ;
+			}
+			_row_start[i+1] = _columns.size() ;
+		}
+	}
+
+
+/*------------------- GETTERS ---------------------*/
+
+	std::size_t nb_rows() const noexcept{ return _nb_rows ; }
+	std::size_t nb_cols() const noexcept{ return _nb_cols ; }
+
+	/// @brief number of nonzero entries
+	std::size_t nnz() const noexcept{ return _columns.size() ; }
+
+	/// @brief entries of row i : [row_start(i), row_start(i+1))
+	std::size_t row_start(const std::size_t i) const noexcept{ return _row_start[i] ; }
+
+	/// @brief column of the entry k
+	std::size_t column(const std::size_t k) const noexcept{ return _columns[k] ; }
+
+	/// @brief numerator of the entry k, over the denominator of its row
+	T numerator(const std::size_t k) const noexcept{ return _numerators[k] ; }
+
+	/// @brief common denominator of row i
+	T row_denominator(const std::size_t i) const noexcept{ return _denominators[i] ; }
+
+	/// @brief entry (i, j), zero if it is not stored
+	Ratio<T> at(const std::size_t i, const std::size_t j) const
+	noexcept{
+		assert( (i < _nb_rows && j < _nb_cols) && "error: index out of the matrix");
+		const auto first = _columns.begin() + _row_start[i], last = _columns.begin() + _row_start[i+1] ;
+		const auto found = std::lower_bound(first, last, j) ;
+		if(found == last || *found != j) return Ratio<T>::zero() ;
+		return Ratio<T>(_numerators[found - _columns.begin()], _denominators[i]) ;
+	}
+
+
+/*------------------- METHODES ---------------------*/
+
+	/// @brief the transpose, i.e. the compressed sparse columns form of the matrix (each column over a common denominator)
+	SparseMatrix transpose() const
+	{
+		std::vector<Triplet> entries ;
+		entries.reserve(nnz()) ;
+		for(std::size_t i = 0; i < _nb_rows; ++i){
+			for(std::size_t k = _row_start[i]; k < _row_start[i+1]; ++k) entries.push_back(Triplet{_columns[k], i, Ratio<T>(_numerators[k], _denominators[i])}) ;
+		}
+		return SparseMatrix(_nb_cols, _nb_rows, std::move(entries)) ;
+	}
+
+	/// @brief the matrix with its rows and columns reordered : entry (i, j) becomes entry (row_position[i], col_position[j])
+	/// @param row_position new position of each row
+	/// @param col_position new position of each column
+	SparseMatrix permute(const std::vector<std::size_t>& row_position, const std::vector<std::size_t>& col_position) const
+	{
+		assert( (row_position.size() == _nb_rows && col_position.size() == _nb_cols) && "error: one position per row and per column");
+		SparseMatrix result(_nb_rows, _nb_cols) ;
+		std::vector<std::size_t> old_row(_nb_rows) ;
+		for(std::size_t i = 0; i < _nb_rows; ++i) old_row[row_position[i]] = i ;
+
+		std::vector<std::pair<std::size_t, T>> row ;
+		for(std::size_t i = 0; i < _nb_rows; ++i){
+			const std::size_t r = old_row[i] ;
+			row.clear() ;
+			for(std::size_t k = _row_start[r]; k < _row_start[r+1]; ++k) row.emplace_back(col_position[_columns[k]], _numerators[k]) ;
+			std::sort(row.begin(), row.end()) ;
+			for(const auto& entry : row){
+				result._columns.push_back(entry.first) ;
+				result._numerators.push_back(entry.second) ;
+			}
+			result._denominators[i] = _denominators[r] ;
+			result._row_start[i+1] = result._columns.size() ;
+		}
+		return result ;
+	}
+
+	/// @brief exact product y = A.x, the rows computed in parallel
+	/// @param x vector of nb_cols ratios
+	/// @param nb_threads number of threads, each one computes a contiguous slice of the rows
+	/// @return the nb_rows ratios of A.x
+	template<class OverflowPolicy>
+	std::vector<Ratio<T, OverflowPolicy>> multiply(const std::vector<Ratio<T, OverflowPolicy>>& x, const std::size_t nb_threads = 1) const
+	{
+		assert( (x.size() == _nb_cols) && "error: the vector must have one value per column");
+		std::vector<Ratio<T, OverflowPolicy>> y(_nb_rows) ;
+		parallel_slices(_nb_rows, nb_threads, [&](const std::size_t first, const std::size_t last){
+			for(std::size_t i = first; i < last; ++i){
+				// sum of the integer numerators times x, divided once by the denominator of the row
+				Ratio<T, OverflowPolicy> sum = Ratio<T, OverflowPolicy>::zero() ;
+				for(std::size_t k = _row_start[i]; k < _row_start[i+1]; ++k) sum += x[_columns[k]] * _numerators[k] ;
+				if(_denominators[i] != 1) sum /= _denominators[i] ;
+				y[i] = sum ;
+			}
+		}) ;
+		return y ;
+	}
+
+	/// @brief fill-reducing ordering of a square matrix : reverse Cuthill-McKee on the pattern of A + A^T.
+	/// The renumbered matrix has a small bandwidth, which bounds the fill of its LU factorization.
+	/// @return position[i], the new index of row and column i (see permute)
+	std::vector<std::size_t> reverse_cuthill_mckee() const
+	{
+		assert( (_nb_rows == _nb_cols) && "error: the matrix must be square");
+		const std::size_t n = _nb_rows ;
+
+		// symmetric adjacency, without the diagonal
+		std::vector<std::size_t> degree(n, 0) ;
+		for(std::size_t i = 0; i < n; ++i){
+			for(std::size_t k = _row_start[i]; k < _row_start[i+1]; ++k){
+				if(_columns[k] == i) continue ;
+				++degree[i] ;
+				++degree[_columns[k]] ;
+			}
+		}
+		std::vector<std::size_t> start(n + 1, 0) ;
+		for(std::size_t i = 0; i < n; ++i) start[i+1] = start[i] + degree[i] ;
+		std::vector<std::size_t> neighbors(start[n]), fill(start.begin(), start.end() - 1) ;
+		for(std::size_t i = 0; i < n; ++i){
+			for(std::size_t k = _row_start[i]; k < _row_start[i+1]; ++k){
+				const std::size_t j = _columns[k] ;
+				if(j == i) continue ;
+				neighbors[fill[i]++] = j ;
+				neighbors[fill[j]++] = i ;
+			}
+		}
+		// an edge stored in both triangles is counted twice, which does not change the breadth-first order
+		for(std::size_t i = 0; i < n; ++i){
+			std::sort(neighbors.begin() + start[i], neighbors.begin() + start[i+1], [&degree](const std::size_t a, const std::size_t b){
+				return (degree[a] != degree[b]) ? degree[a] < degree[b] : a < b ;
+			}) ;
+		}
+
+		// breadth-first search from a node of minimum degree of each connected component
+		std::vector<std::size_t> by_degree(n) ;
+		std::iota(by_degree.begin(), by_degree.end(), 0) ;
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](const std::size_t a, const std::size_t b){ return degree[a] < degree[b] ; }) ;
+		std::vector<std::size_t> order ;
+		order.reserve(n) ;
+		std::vector<char> visited(n, 0) ;
+		for(const std::size_t root : by_degree){
+			if(visited[root]) continue ;
+			visited[root] = 1 ;
+			order.push_back(root) ;
+			for(std::size_t head = order.size() - 1; head < order.size(); ++head){
+				const std::size_t i = order[head] ;
+				for(std::size_t k = start[i]; k < start[i+1]; ++k){
+					if(visited[neighbors[k]]) continue ;
+					visited[neighbors[k]] = 1 ;
+					order.push_back(neighbors[k]) ;
+				}
+			}
+		}
+
+		std::vector<std::size_t> position(n) ;
+		for(std::size_t k = 0; k < n; ++k) position[order[n - 1 - k]] = k ;
+		return position ;
+	}
+};
+
+
+namespace modular {
+
+	/// @class SparseElimination
+	/// @brief gaussian elimination of a sparse square system modulo a prime. The rows are sparse vectors of residues ;
+	/// the columns are eliminated in a fill-reducing order, and the pivot of a column is the shortest row having it (Markowitz),
+	/// so the work follows the fill instead of n^3.
+	class SparseElimination {
+
+	private :
+		/// @brief a sparse row : (column, residue in Montgomery form), sorted by column
+		using Row = std::vector<std::pair<std::size_t, std::uint64_t>> ;
+
+		Field _field ;
+		std::vector<Row> _rows ;
+		std::vector<std::uint64_t> _rhs ;
+
+		/// @brief row_i -= f * row_p, for the columns after the first one of row_p ; the new columns of row_i are reported to fill(col)
+		template<class Fill>
+		void subtract_row(Row& row_i, const Row& row_p, const std::uint64_t f, Row& buffer, Fill fill) const
+		{
+			buffer.clear() ;
+			std::size_t a = 1, b = 1 ;
+			while(a < row_i.size() || b < row_p.size()){
+				if(b == row_p.size() || (a < row_i.size() && row_i[a].first < row_p[b].first)){
+					buffer.push_back(row_i[a++]) ;
+				}
+				else if(a == row_i.size() || row_p[b].first < row_i[a].first){
+					fill(row_p[b].first) ;
+					buffer.emplace_back(row_p[b].first, _field.neg(_field.mul(f, row_p[b].second))) ;
+					++b ;
+				}
+				else {
+					const std::uint64_t v = _field.sub(row_i[a].second, _field.mul(f, row_p[b].second)) ;
+					if(v != 0) buffer.emplace_back(row_i[a].first, v) ;
+					++a ;
+					++b ;
+				}
+			}
+			row_i.swap(buffer) ;
+		}
+
+	public :
+
+	/*------------------- CONSTRUCT0R ---------------------*/
+
+		/// @brief residues of the system A.x = b, with its columns renumbered
+		/// @param field the field of the residues
+		/// @param A the square matrix
+		/// @param b the right-hand side
+		/// @param position new index of each column (e.g. A.reverse_cuthill_mckee())
+		/// @param ok set to false if a denominator is a multiple of the prime
+		template<class T, class OverflowPolicy>
+		SparseElimination(const Field& field, const SparseMatrix<T>& A, const std::vector<Ratio<T, OverflowPolicy>>& b, const std::vector<std::size_t>& position, bool& ok)
+		: _field(field), _rows(A.nb_rows()), _rhs(A.nb_rows(), 0) {
+			ok = true ;
+			for(std::size_t i = 0; i < A.nb_rows(); ++i){
+				const std::uint64_t den = _field.from_integer(A.row_denominator(i)) ;
+				if(den == 0){
+					ok = false ;
+					return ;
+				}
+				const std::uint64_t inv = _field.inverse(den) ;
+				Row& row = _rows[i] ;
+				for(std::size_t k = A.row_start(i); k < A.row_start(i+1); ++k){
+					const std::uint64_t v = _field.mul(_field.from_integer(A.numerator(k)), inv) ;
+					if(v != 0) row.emplace_back(position[A.column(k)], v) ;
+				}
+				std::sort(row.begin(), row.end()) ;
+				ok &= _field.from_ratio(b[i], _rhs[i]) ;
+			}
+		}
+
+
+	/*------------------- METHODES ---------------------*/
+
+		/// @brief solve the system
+		/// @param x the solution (Montgomery form), indexed by the new column numbers
+		/// @return false if the system is singular modulo the prime
+		bool solve(std::vector<std::uint64_t>& x)
+		{
+			const std::size_t n = _rows.size() ;
+			// rows having an entry in each column, possibly stale (checked when used)
+			std::vector<std::vector<std::size_t>> column_rows(n) ;
+			for(std::size_t i = 0; i < n; ++i){
+				for(const auto& entry : _rows[i]) column_rows[entry.first].push_back(i) ;
+			}
+
+			// the rows not yet pivot have no entry before the current column j : they have column j iff it is their first one
+			std::vector<std::size_t> pivot(n) ;
+			std::vector<char> used(n, 0) ;
+			std::vector<std::size_t> seen(n, n), candidates ;
+			Row buffer ;
+			for(std::size_t j = 0; j < n; ++j){
+				candidates.clear() ;
+				for(const std::size_t i : column_rows[j]){
+					if(used[i] || seen[i] == j || _rows[i].empty() || _rows[i].front().first != j) continue ;
+					seen[i] = j ;
+					candidates.push_back(i) ;
+				}
+				column_rows[j].clear() ;
+				column_rows[j].shrink_to_fit() ;
+				if(candidates.empty()) return false ;
+
+				const std::size_t p = *std::min_element(candidates.begin(), candidates.end(), [this](const std::size_t a, const std::size_t b){ return _rows[a].size() < _rows[b].size() ; }) ;
+				used[p] = 1 ;
+				pivot[j] = p ;
+				const std::uint64_t inv = _field.inverse(_rows[p].front().second) ;
+				for(const std::size_t i : candidates){
+					if(i == p) continue ;
+					const std::uint64_t f = _field.mul(_rows[i].front().second, inv) ;
+					subtract_row(_rows[i], _rows[p], f, buffer, [&column_rows, i](const std::size_t col){ column_rows[col].push_back(i) ; }) ;
+					_rhs[i] = _field.sub(_rhs[i], _field.mul(f, _rhs[p])) ;
+				}
+			}
+
+			// back substitution on the pivot rows, upper triangular in the new column order
+			x.assign(n, 0) ;
+			for(std::size_t j = n; j > 0; --j){
+				const Row& row = _rows[pivot[j-1]] ;
+				std::uint64_t s = _rhs[pivot[j-1]] ;
+				for(std::size_t k = 1; k < row.size(); ++k) s = _field.sub(s, _field.mul(row[k].second, x[row[k].first])) ;
+				x[j-1] = _field.mul(s, _field.inverse(row.front().second)) ;
+			}
+			return true ;
+		}
+	};
+
+
+	/// @brief exact solution of the sparse square system A.x = b, by sparse elimination modulo several primes :
+	/// the intermediate values stay residues of 64 bits, whatever the size of the exact ones.
+	/// The solution itself is limited by the fixed width of the chinese remainder theorem : at most Reconstruction::max_primes primes
+	/// of 63 bits (a 384 bits modulus), enough for the numerators and denominators of an Out of up to 128 bits, not more.
+	/// A solution which does not fit in Out throws std::overflow_error once the primes are exhausted ;
+	/// nothing limits the growth of the exact values, a wider result needs a wider Out.
+	/// @tparam Out integer type of the solution (default : T), at most ratio_int128
+	/// @param A the matrix
+	/// @param b the right-hand side
+	/// @param x the solution
+	/// @param nb_threads number of primes processed in parallel
+	/// @return false if A is singular ; throws std::overflow_error if the solution does not fit in Out
+	template<class Out = void, class T, class OverflowPolicy>
+	bool solve(const SparseMatrix<T>& A, const std::vector<Ratio<T, OverflowPolicy>>& b, std::vector<Ratio<detail::result_t<Out, T>>>& x, const std::size_t nb_threads = 1)
+	{
+		using U = detail::result_t<Out, T> ;
+		assert( (A.nb_rows() == A.nb_cols() && A.nb_rows() == b.size()) && "error: the matrix must be square, with one right-hand side per row");
+		const std::vector<std::size_t> position = A.reverse_cuthill_mckee() ;
+		std::vector<Ratio<U>> permuted ;
+		const bool solved = detail::multi_modular<U>(A.nb_rows(), nb_threads, [&A, &b, &position](const Field& field, std::vector<std::uint64_t>& residues){
+			bool ok = true ;
+			SparseElimination elimination(field, A, b, position, ok) ;
+			return ok && elimination.solve(residues) ;
+		}, permuted) ;
+		x.resize(A.nb_cols()) ;
+		for(std::size_t j = 0; j < A.nb_cols(); ++j) x[j] = permuted[position[j]] ;
+		return solved ;
+	}
+
+}
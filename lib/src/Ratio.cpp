@@ -1,2 +1,13 @@
 #include "Ratio.hpp"
 
+
+// explicit instantiations of the common integer types, declared extern in Ratio.hpp
+template class Ratio<int> ;
+template class Ratio<long int> ;
+template class Ratio<long long int> ;
+template class Ratio<unsigned int> ;
+template class Ratio<unsigned long int> ;
+template class Ratio<unsigned long long int> ;
+#if defined(RATIO_HAS_INT128_TRAITS)
+template class Ratio<ratio_int128> ;
+#endif
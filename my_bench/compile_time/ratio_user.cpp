@@ -0,0 +1,18 @@
+// typical user translation unit, compiled by the benchmark compile_time (my_bench/src/compile_time.cpp)
+// with and without the extern template declarations of Ratio.hpp
+#include "Ratio.hpp"
+
+
+template<class T>
+Ratio<T> use_ratio(const Ratio<T>& a, const Ratio<T>& b)
+{
+	Ratio<T> r = a + b - a * b / (b + Ratio<T>::one()) ;
+	r = r.abs() + Ratio<T>::pow2(-a, 3) + r.limit_denominator(1000) ;
+	if(Ratio<T>::compare(r, b) < 0 && r != a && r >= b.inverse()) r = r * 2 ;
+	std::cout << r << " " << r.to_double() << " " << r.to_float() << " " << Ratio<T>::convert_float_to_ratio(r.to_double(), 10) << std::endl ;
+	return r ;
+}
+
+template Ratio<int> use_ratio(const Ratio<int>&, const Ratio<int>&) ;
+template Ratio<long int> use_ratio(const Ratio<long int>&, const Ratio<long int>&) ;
+template Ratio<long long int> use_ratio(const Ratio<long long int>&, const Ratio<long long int>&) ;
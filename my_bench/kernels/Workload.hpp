@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Ratio.hpp"
+
+
+// common part of the workload kernels (my_bench/src/kernel_*.cpp) : each kernel is an exact computation on Ratio
+// run for growing sizes n, with 64 bits components widened in 128 bits (overflow::Promote) and with 128 bits components
+// (overflow::Checked, there is no wider type) ; a kernel stops at the first size whose values do not fit.
+// Each kernel is built twice (see my_bench/CMakeLists.txt) : kernel_* reports the best time of each size, and kernel_*_count,
+// built with RATIO_COUNT_GCD, reports the number of gcds and the peak bit-width of the values, so the timed runs do not pay the counter.
+
+
+/// @brief type of the values of the kernels, 64 bits components
+using workload_ratio = Ratio<long int, overflow::Promote> ;
+
+/// @brief type of the values of the kernels, 128 bits components
+using workload_ratio128 = Ratio<ratio_int128, overflow::Checked> ;
+
+/// @brief integer type of the components of the ratio type R
+template<class R>
+using workload_int = typename std::decay<decltype(std::declval<R>().get_numerator())>::type ;
+
+
+/// @brief records the largest bit-width of the components of the values given to observe
+class BitWidthProbe {
+
+private :
+	int _peak = 0 ;
+
+	/// @brief number of bits of |x|
+	template<class T>
+	static int bit_width(const T x)
+	noexcept{
+		int bits = 0 ;
+		for(auto magnitude = ratio_magnitude(x); magnitude != 0; magnitude >>= 1) ++bits ;
+		return bits ;
+	}
+
+public :
+	/// @brief take a value of the kernel into account
+	template<class T, class OverflowPolicy>
+	void observe(const Ratio<T, OverflowPolicy>& r)
+	noexcept{
+		const int bits = std::max(bit_width(r.get_numerator()), bit_width(r.get_denominator())) ;
+		if(bits > _peak) _peak = bits ;
+	}
+
+	/// @brief largest bit-width observed
+	int peak() const noexcept{ return _peak ; }
+};
+
+/// @brief probe of the timed runs, observes nothing
+struct NullProbe {
+	template<class T, class OverflowPolicy>
+	void observe(const Ratio<T, OverflowPolicy>&) noexcept{}
+};
+
+
+/// @brief run a kernel for each size and display its best time (or, built with RATIO_COUNT_GCD, its gcd count and peak bit-width),
+/// stop at the first overflow
+/// @param name name of the kernel
+/// @param sizes the sizes n, increasing
+/// @param nb_runs number of timed runs for each size, the best time is kept
+/// @param kernel called as kernel(n, probe), returns the result of the computation (a ratio)
+template<class Kernel>
+void run_workload(const std::string& name, const std::vector<std::size_t>& sizes, const int nb_runs, Kernel kernel)
+{
+	std::cout << name << std::endl ;
+	for(const std::size_t n : sizes){
+		try {
+		#ifdef RATIO_COUNT_GCD
+			// one run counting the gcds and observing the values
+			static_cast<void>(nb_runs) ;
+			BitWidthProbe probe ;
+			ratio_gcd_count = 0 ;
+			const auto result = kernel(n, probe) ;
+			std::cout << "  n = " << n << " : " << ratio_gcd_count << " gcd, peak " << probe.peak() << " bits, result " << result << std::endl ;
+		#else
+			// timed runs without probe, they must all give the result of the first one
+			NullProbe probe ;
+			const auto result = kernel(n, probe) ;
+			double best = 0.0 ;
+			for(int run=0; run<nb_runs; ++run){
+				const auto start = std::chrono::steady_clock::now() ;
+				const auto check = kernel(n, probe) ;
+				const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start ;
+				if(check != result) std::cerr << "error: different results between two runs" << std::endl ;
+				if(run == 0 || elapsed.count() < best) best = elapsed.count() ;
+			}
+			std::cout << "  n = " << n << " : " << best << " s, result " << result << std::endl ;
+		#endif
+		}
+		catch(const std::overflow_error&){
+			std::cout << "  n = " << n << " : overflow of the components, stop" << std::endl ;
+			return ;
+		}
+	}
+}
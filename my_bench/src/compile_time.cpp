@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+// build time of a typical user translation unit (compile_time/ratio_user.cpp), with and without the extern
+// template declarations of Ratio.hpp. The compiler and the paths are given by CMake (my_bench/CMakeLists.txt).
+
+
+/// @brief compile a file, display the elapsed time and the size of the object file
+/// @param label name of the measure
+/// @param flags compilation flags
+/// @param source file to compile
+/// @param object output object file
+/// @param nb_runs number of compilations, the best time is kept
+void measure(const std::string& label, const std::string& flags, const std::string& source, const std::string& object, const int nb_runs)
+{
+	const std::string command = std::string(RATIO_BENCH_CXX) + " -std=gnu++17 -I" + RATIO_BENCH_INCLUDE + " " + flags + " -c " + source + " -o " + object ;
+
+	double best = 0.0 ;
+	for(int run=0; run<nb_runs; ++run){
+		const auto start = std::chrono::steady_clock::now() ;
+		if(std::system(command.c_str()) != 0){
+			std::cerr << "compilation failed : " << command << std::endl ;
+			return ;
+		}
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start ;
+		if(run == 0 || elapsed.count() < best) best = elapsed.count() ;
+	}
+
+	std::ifstream file(object, std::ios::binary | std::ios::ate) ;
+	std::cout << label << " : " << best << " s, object " << file.tellg() << " bytes" << std::endl ;
+}
+
+
+int main(int argc, char** argv){
+
+	const int nb_runs = (argc > 1) ? std::atoi(argv[1]) : 3 ;
+	const std::string output = RATIO_BENCH_OUTPUT ;
+
+	// at -O0 the instantiations are not compiled again, at -O2 the compiler still reads them to inline them
+	for(const std::string optimization : {"-O0", "-O2"}){
+		std::cout << "best of " << nb_runs << " compilations (" << optimization << ")" << std::endl ;
+		measure("user file, extern template (Ratio in the library)", optimization, RATIO_BENCH_SOURCE, output + "/ratio_user_extern.o", nb_runs) ;
+		measure("user file, RATIO_NO_EXTERN_TEMPLATE             ", optimization + " -DRATIO_NO_EXTERN_TEMPLATE", RATIO_BENCH_SOURCE, output + "/ratio_user_instantiated.o", nb_runs) ;
+		measure("library, explicit instantiations (once)         ", optimization, RATIO_BENCH_LIBRARY_SOURCE, output + "/ratio_instantiations.o", nb_runs) ;
+	}
+
+	return 0 ;
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "RatioFile.hpp"
+
+
+// time to get a dataset of ratios back in memory : parsing "n/d" text with iostream
+// versus mapping the columnar file of RatioFile.hpp (the checksum scan is measured apart)
+
+
+/// @brief run f once, display the elapsed time and the sum of the denominators read
+template<class Function>
+void measure(const std::string& label, Function f)
+{
+	const auto start = std::chrono::steady_clock::now() ;
+	const long int checksum = f() ;
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start ;
+	std::cout << label << " : " << elapsed.count() << " s (checksum " << checksum << ")" << std::endl ;
+}
+
+
+int main(int argc, char** argv){
+
+	const std::size_t nb_ratios = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000 ;
+	const std::string text_path = "ratios.txt" ;
+	const std::string column_path = "ratios.col" ;
+
+	std::mt19937 generator(0) ;
+	std::uniform_int_distribution<long int> distribution(-1000000000, 1000000000) ;
+	std::vector<Ratio<long int>> ratios ;
+	ratios.reserve(nb_ratios) ;
+	for(std::size_t i = 0; i < nb_ratios; ++i) ratios.emplace_back(distribution(generator), 1 + std::abs(distribution(generator))) ;
+
+	{
+		std::ofstream text(text_path) ;
+		for(const Ratio<long int>& r : ratios) text << r << '\n' ;
+	}
+	write_ratio_file(column_path, ratios) ;
+	std::cout << nb_ratios << " ratios" << std::endl ;
+
+	measure("parse text, first ratio    ", [&](){
+		std::ifstream text(text_path) ;
+		std::vector<Ratio<long int>> loaded ;
+		long int num, den ;
+		char slash ;
+		while(text >> num >> slash >> den) loaded.emplace_back(num, den) ;
+		return loaded.front().get_denominator() ;
+	}) ;
+	measure("map file, first ratio      ", [&](){
+		const MappedRatioFile<long int> file(column_path) ;
+		return file[0].get_denominator() ;
+	}) ;
+	measure("map file, scan all ratios  ", [&](){
+		const MappedRatioFile<long int> file(column_path) ;
+		long int sum = 0 ;
+		for(const long int den : file.denominators()) sum += den ;
+		return sum ;
+	}) ;
+	measure("map file, verify checksums ", [&](){
+		const MappedRatioFile<long int> file(column_path) ;
+		return static_cast<long int>(file.verify()) ;
+	}) ;
+
+	std::remove(text_path.c_str()) ;
+	std::remove(column_path.c_str()) ;
+	return 0 ;
+}
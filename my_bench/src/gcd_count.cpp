@@ -0,0 +1,51 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Ratio.hpp"
+
+
+// number of gcds computed by each operation of Ratio, counted by ratio_gcd (RATIO_COUNT_GCD, linked with RatioCount, see my_bench/CMakeLists.txt)
+
+
+/// @brief display the mean number of gcds of op over the pairs of ratios
+template<class Operation>
+void measure(const std::string& label, const std::vector<Ratio<long int>>& a, const std::vector<Ratio<long int>>& b, Operation op)
+{
+	long int checksum = 0 ;
+	ratio_gcd_count = 0 ;
+	for(std::size_t i = 0; i < a.size(); ++i) checksum += op(a[i], b[i]).get_denominator() ;
+	std::cout << label << " : " << static_cast<double>(ratio_gcd_count) / static_cast<double>(a.size()) << " gcd per operation (checksum " << checksum << ")" << std::endl ;
+}
+
+
+int main(){
+
+	const std::size_t nb_ratios = 100000 ;
+	std::mt19937 generator(0) ;
+	std::uniform_int_distribution<long int> numDistribution(-100000, 100000) ;
+	std::uniform_int_distribution<long int> denDistribution(1, 100000) ;
+
+	std::vector<Ratio<long int>> a, b ;
+	for(std::size_t i = 0; i < nb_ratios; ++i){
+		a.emplace_back(numDistribution(generator), denDistribution(generator)) ;
+		b.emplace_back(numDistribution(generator) | 1, denDistribution(generator)) ;
+	}
+
+	measure("a + b        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return x + y ; }) ;
+	measure("a - b        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return x - y ; }) ;
+	measure("a * b        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return x * y ; }) ;
+	measure("a / b        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return x / y ; }) ;
+	measure("a * 3        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>&){ return x * 3 ; }) ;
+	measure("a / 3        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>&){ return x / 3 ; }) ;
+	measure("a + 3        ", a, b, [](const Ratio<long int>& x, const Ratio<long int>&){ return x + 3 ; }) ;
+	measure("a + int      ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return x + Ratio<long int>(y.get_numerator(), 1, reduced_tag) ; }) ;
+	measure("int * int    ", a, b, [](const Ratio<long int>& x, const Ratio<long int>& y){ return Ratio<long int>(x.get_numerator(), 1, reduced_tag) * Ratio<long int>(y.get_numerator(), 1, reduced_tag) ; }) ;
+	measure("-a           ", a, b, [](const Ratio<long int>& x, const Ratio<long int>&){ return -x ; }) ;
+	measure("a.abs()      ", a, b, [](const Ratio<long int>& x, const Ratio<long int>&){ return x.abs() ; }) ;
+	measure("b.inverse()  ", a, b, [](const Ratio<long int>&, const Ratio<long int>& y){ return y.inverse() ; }) ;
+	measure("zero() + one()", a, b, [](const Ratio<long int>&, const Ratio<long int>&){ return Ratio<long int>::zero() + Ratio<long int>::one() ; }) ;
+
+	return 0 ;
+}
@@ -0,0 +1,39 @@
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "Workload.hpp"
+
+
+// Bernoulli numbers B_0 ... B_n with the Akiyama-Tanigawa algorithm : O(n^2) subtractions and products
+// by integers on a triangle of ratios whose numerators grow quickly
+
+
+/// @brief B_n (convention B_1 = +1/2)
+template<class R, class Probe>
+R bernoulli(const std::size_t n, Probe& probe)
+{
+	std::vector<R> a(n + 1) ;
+	for(std::size_t m = 0; m <= n; ++m){
+		a[m] = R(1, static_cast<workload_int<R>>(m + 1)) ;
+		for(std::size_t j = m; j >= 1; --j){
+			a[j-1] -= a[j] ;
+			a[j-1] *= static_cast<workload_int<R>>(j) ;
+			probe.observe(a[j-1]) ;
+		}
+	}
+	return a[0] ;
+}
+
+
+int main(int argc, char** argv){
+
+	const int nb_runs = (argc > 1) ? std::atoi(argv[1]) : 100 ;
+	run_workload("Bernoulli numbers B_n (Akiyama-Tanigawa), 64 bits", {4, 8, 12, 16, 20, 24, 28, 32, 36, 40}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return bernoulli<workload_ratio>(n, probe) ; }) ;
+	run_workload("Bernoulli numbers B_n (Akiyama-Tanigawa), 128 bits", {4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 48, 56, 64, 72, 80}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return bernoulli<workload_ratio128>(n, probe) ; }) ;
+
+	return 0 ;
+}
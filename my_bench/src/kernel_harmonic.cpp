@@ -0,0 +1,33 @@
+#include <cstddef>
+#include <cstdlib>
+
+#include "Ratio.hpp"
+#include "Workload.hpp"
+
+
+// harmonic numbers H_n = 1 + 1/2 + ... + 1/n : the denominator grows like lcm(1..n), about e^n
+
+
+/// @brief H_n
+template<class R, class Probe>
+R harmonic(const std::size_t n, Probe& probe)
+{
+	R h = R::zero() ;
+	for(std::size_t k = 1; k <= n; ++k){
+		h += R(1, static_cast<workload_int<R>>(k)) ;
+		probe.observe(h) ;
+	}
+	return h ;
+}
+
+
+int main(int argc, char** argv){
+
+	const int nb_runs = (argc > 1) ? std::atoi(argv[1]) : 1000 ;
+	run_workload("harmonic numbers H_n, 64 bits", {10, 20, 30, 40, 42, 44, 46, 48, 50}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return harmonic<workload_ratio>(n, probe) ; }) ;
+	run_workload("harmonic numbers H_n, 128 bits", {10, 20, 30, 40, 50, 60, 70, 80, 90, 100}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return harmonic<workload_ratio128>(n, probe) ; }) ;
+
+	return 0 ;
+}
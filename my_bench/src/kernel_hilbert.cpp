@@ -0,0 +1,56 @@
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "Ratio.hpp"
+#include "Workload.hpp"
+
+
+// inverse of the Hilbert matrix H_ij = 1/(i+j+1) by Gauss-Jordan elimination : the inverse has integer
+// coefficients, but the intermediate values of the elimination have large numerators and denominators
+
+
+/// @brief sum of the coefficients of the inverse of the n x n Hilbert matrix (it is n^2)
+template<class R, class Probe>
+R hilbert_inverse(const std::size_t n, Probe& probe)
+{
+	// [H | I], reduced to [I | H^-1] ; H is positive definite, the pivots are never null
+	const std::size_t width = 2 * n ;
+	std::vector<R> m(n * width, R::zero()) ;
+	for(std::size_t i = 0; i < n; ++i){
+		for(std::size_t j = 0; j < n; ++j) m[i*width + j] = R(1, static_cast<workload_int<R>>(i + j + 1)) ;
+		m[i*width + n + i] = R::one() ;
+	}
+
+	for(std::size_t k = 0; k < n; ++k){
+		const R pivot = m[k*width + k] ;
+		for(std::size_t j = k; j < width; ++j) m[k*width + j] /= pivot ;
+		for(std::size_t i = 0; i < n; ++i){
+			if(i == k) continue ;
+			const R factor = m[i*width + k] ;
+			if(factor == R::zero()) continue ;
+			for(std::size_t j = k; j < width; ++j){
+				m[i*width + j] -= factor * m[k*width + j] ;
+				probe.observe(m[i*width + j]) ;
+			}
+		}
+	}
+
+	R sum = R::zero() ;
+	for(std::size_t i = 0; i < n; ++i){
+		for(std::size_t j = n; j < width; ++j) sum += m[i*width + j] ;
+	}
+	return sum ;
+}
+
+
+int main(int argc, char** argv){
+
+	const int nb_runs = (argc > 1) ? std::atoi(argv[1]) : 100 ;
+	run_workload("inverse of the Hilbert matrix (sum of the coefficients), 64 bits", {2, 4, 6, 8, 10, 12, 14, 16}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return hilbert_inverse<workload_ratio>(n, probe) ; }) ;
+	run_workload("inverse of the Hilbert matrix (sum of the coefficients), 128 bits", {2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return hilbert_inverse<workload_ratio128>(n, probe) ; }) ;
+
+	return 0 ;
+}
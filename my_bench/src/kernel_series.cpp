@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdlib>
+
+#include "Ratio.hpp"
+#include "Workload.hpp"
+
+
+// exact partial sums of series : e = sum 1/k! (factorial denominators, the sum stays small),
+// pi^2/6 = sum 1/k^2 (squares of lcm(1..n)) and pi/4 = sum (-1)^k/(2k+1) (alternating odd denominators)
+
+
+/// @brief sum_{k=0}^{n} 1/k!
+template<class R, class Probe>
+R exponential(const std::size_t n, Probe& probe)
+{
+	R term = R::one() ;
+	R sum = R::one() ;
+	for(std::size_t k = 1; k <= n; ++k){
+		term /= static_cast<workload_int<R>>(k) ;
+		sum += term ;
+		probe.observe(sum) ;
+	}
+	return sum ;
+}
+
+/// @brief sum_{k=1}^{n} 1/k^2
+template<class R, class Probe>
+R basel(const std::size_t n, Probe& probe)
+{
+	R sum = R::zero() ;
+	for(std::size_t k = 1; k <= n; ++k){
+		const workload_int<R> kk = static_cast<workload_int<R>>(k) ;
+		sum += R(1, kk * kk) ;
+		probe.observe(sum) ;
+	}
+	return sum ;
+}
+
+/// @brief sum_{k=0}^{n} (-1)^k/(2k+1)
+template<class R, class Probe>
+R leibniz(const std::size_t n, Probe& probe)
+{
+	R sum = R::zero() ;
+	for(std::size_t k = 0; k <= n; ++k){
+		sum += R((k % 2 == 0) ? 1 : -1, static_cast<workload_int<R>>(2*k + 1)) ;
+		probe.observe(sum) ;
+	}
+	return sum ;
+}
+
+
+int main(int argc, char** argv){
+
+	const int nb_runs = (argc > 1) ? std::atoi(argv[1]) : 1000 ;
+	run_workload("e = sum 1/k!, 64 bits", {5, 10, 15, 18, 20, 22}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return exponential<workload_ratio>(n, probe) ; }) ;
+	run_workload("e = sum 1/k!, 128 bits", {5, 10, 15, 18, 20, 22, 26, 30, 34}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return exponential<workload_ratio128>(n, probe) ; }) ;
+	run_workload("pi^2/6 = sum 1/k^2, 64 bits", {5, 10, 15, 20, 22, 24, 26}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return basel<workload_ratio>(n, probe) ; }) ;
+	run_workload("pi^2/6 = sum 1/k^2, 128 bits", {5, 10, 15, 20, 22, 24, 26, 30, 35, 40, 45}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return basel<workload_ratio128>(n, probe) ; }) ;
+	run_workload("pi/4 = sum (-1)^k/(2k+1), 64 bits", {5, 10, 15, 20, 25, 30, 35}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return leibniz<workload_ratio>(n, probe) ; }) ;
+	run_workload("pi/4 = sum (-1)^k/(2k+1), 128 bits", {5, 10, 15, 20, 25, 30, 35, 45, 55, 65, 75}, nb_runs,
+	             [](const std::size_t n, auto& probe){ return leibniz<workload_ratio128>(n, probe) ; }) ;
+
+	return 0 ;
+}
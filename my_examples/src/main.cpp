@@ -1,7 +1,9 @@
 #include <iostream>
 #include <chrono>
+#include <string>
 
 #include "Ratio.hpp"
+#include "Decimal.hpp"
 
 
 
@@ -140,6 +142,15 @@ void conversion(){
   std::cout << "2.9304973e-10 = " << Ratio<int>::convert_float_to_ratio(0.00000000029304973, 5) << std::endl ; 
   std::cout << "-1/-2147483648 = " << Ratio<int>(-1,-2147483648).convert_ratio_to_float() << std::endl ; 
 
+  // pour une conversion exacte, on passe par le texte décimal, avec la période entre parenthèses
+  const std::string text = "0.(142857)" ; 
+  Ratio<int> exact ; 
+  from_decimal_chars(text.data(), text.data() + text.size(), exact) ; 
+  std::cout << text << " = " << exact << std::endl ; 
+  char buffer[32] ; 
+  std::cout << "1/7 = " << std::string(buffer, to_decimal_chars(buffer, buffer + sizeof(buffer), r).ptr) << std::endl ; 
+  std::cout << "1/7 = " << std::string(buffer, to_decimal_chars(buffer, buffer + sizeof(buffer), r, 10).ptr) << " (10 chiffres)" << std::endl ; 
+
 }
 
 
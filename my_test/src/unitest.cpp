@@ -1,8 +1,29 @@
 #include <random>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <sstream>
 #include <gtest/gtest.h>
 
 #include "Ratio.hpp"
+#include "Farey.hpp"
+#include "DenominatorCompactor.hpp"
+#include "ConcurrentRatioAccumulator.hpp"
+#include "RatioStats.hpp"
+#include "CommonDenomVector.hpp"
+#include "Fixed.hpp"
+#include "RatioIndex.hpp"
+#include "BucketedSum.hpp"
+#include "Simplex.hpp"
+#include "ContinuedFraction.hpp"
+#include "Modular.hpp"
+#include "Geometry.hpp"
+#include "Rescale.hpp"
+#include "RatioFile.hpp"
+#include "Expression.hpp"
+#include "SparseMatrix.hpp"
+#include "Decimal.hpp"
 
 
 constexpr double epsilon = 0.0001;
@@ -245,6 +266,15 @@ TEST (RatioArithmetic, equals) {
 	}
 }
 
+TEST (RatioArithmetic, not_equals) {
+	// ratios sharing only their numerator or only their denominator are different
+	ASSERT_EQ (Ratio<long int>(1,2) != Ratio<long int>(1,3), true);
+	ASSERT_EQ (Ratio<long int>(1,3) != Ratio<long int>(2,3), true);
+	ASSERT_EQ (Ratio<long int>(1,2) != Ratio<long int>(3,4), true);
+	ASSERT_EQ (Ratio<long int>(2,4) != Ratio<long int>(1,2), false);
+	ASSERT_EQ (Ratio<long int>::zero() != Ratio<long int>::zero(), false);
+}
+
 TEST (RatioArithmetic, lower_equal){
 	Ratio<long int> r1(1,2);
 	Ratio<long int> r2(3,2);
@@ -298,6 +328,82 @@ TEST (RatioArithmetic, upper_to){
 	ASSERT_EQ(lower, false);	
 }
 
+TEST (RatioArithmetic, compound_assignment){
+	static_assert(std::is_trivially_copyable<Ratio<long int>>::value, "Ratio must be trivially copyable");
+
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<long int> distribution(-1000, 1000);
+	for(int run=0; run<100; ++run){
+		const Ratio<long int> r1(distribution(generator), 1 + std::abs(distribution(generator)));
+		Ratio<long int> r2(distribution(generator), 1 + std::abs(distribution(generator)));
+		if(r2 == Ratio<long int>::zero()) r2 = Ratio<long int>::one();
+		const int nb = static_cast<int>(distribution(generator)) | 1;
+
+		Ratio<long int> r = r1;
+		ASSERT_EQ (r += r2, r1 + r2);
+		r = r1;
+		ASSERT_EQ (r -= r2, r1 - r2);
+		r = r1;
+		ASSERT_EQ (r *= r2, r1 * r2);
+		r = r1;
+		ASSERT_EQ (r /= r2, r1 / r2);
+		r = r1;
+		ASSERT_EQ (r += nb, r1 + Ratio<long int>(nb));
+		r = r1;
+		ASSERT_EQ (r -= nb, r1 - Ratio<long int>(nb));
+		r = r1;
+		ASSERT_EQ (r *= nb, r1 * nb);
+		r = r1;
+		ASSERT_EQ (r /= nb, r1 / nb);
+	}
+
+	Ratio<long int> harmonic;
+	for(int k=1; k<=10; ++k) harmonic += Ratio<long int>(1,k);
+	ASSERT_EQ (harmonic, Ratio<long int>(7381,2520));
+}
+
+TEST (RatioArithmetic, integer_fast_paths){
+	std::mt19937 generator(11);
+	std::uniform_int_distribution<long int> distribution(-100000, 100000);
+	for(int run=0; run<1000; ++run){
+		const long int n = distribution(generator), d = 1 + std::abs(distribution(generator));
+		const long int k = distribution(generator) | 1;
+		const Ratio<long int> r(n, d), integer(k);
+
+		// reference results, computed with the normalizing constructor
+		ASSERT_EQ (r + k, Ratio<long int>(n + k*d, d));
+		ASSERT_EQ (k + r, Ratio<long int>(n + k*d, d));
+		ASSERT_EQ (r - k, Ratio<long int>(n - k*d, d));
+		ASSERT_EQ (k - r, Ratio<long int>(k*d - n, d));
+		ASSERT_EQ (r * k, Ratio<long int>(n*k, d));
+		ASSERT_EQ (k * r, Ratio<long int>(n*k, d));
+		ASSERT_EQ (r / k, Ratio<long int>(n, d*k));
+		ASSERT_EQ (r + integer, Ratio<long int>(n + k*d, d));
+		ASSERT_EQ (integer + r, Ratio<long int>(n + k*d, d));
+		ASSERT_EQ (integer - r, Ratio<long int>(k*d - n, d));
+		ASSERT_EQ (integer * r, Ratio<long int>(n*k, d));
+		ASSERT_EQ (r / integer, Ratio<long int>(n, d*k));
+		ASSERT_EQ (integer * integer, Ratio<long int>(k*k));
+		if(n != 0){
+			ASSERT_EQ (k / r, Ratio<long int>(k*d, n));
+			ASSERT_EQ (integer / r, Ratio<long int>(k*d, n));
+		}
+	}
+
+	// the integer operand is a long int, not truncated to int
+	const long int big = 3000000000L;
+	ASSERT_EQ ((Ratio<long int>(1,3) * big).get_numerator(), 1000000000L);
+	ASSERT_EQ ((big * Ratio<long int>(1,3)).get_numerator(), 1000000000L);
+	ASSERT_EQ ((Ratio<long int>(1) + big).get_numerator(), big + 1);
+	ASSERT_EQ (Ratio<long int>(3) / -6, Ratio<long int>(-1,2));
+
+	// overflow policies still apply
+	using Checked = Ratio<int, overflow::Checked>;
+	using Promoted = Ratio<int, overflow::Promote>;
+	ASSERT_THROW (Checked(std::numeric_limits<int>::max()) + 1, std::overflow_error);
+	ASSERT_EQ (Promoted(std::numeric_limits<int>::max(), 2) * 2, Promoted(std::numeric_limits<int>::max()));
+}
+
 
 
 /*------------------- METHODE ---------------------*/
@@ -627,3 +733,1598 @@ TEST (RatioMethode, nth_root) {
 	}
 }
 
+
+
+/*------------------- OVERFLOW POLICY ---------------------*/
+
+TEST (RatioOverflow, default_policy_is_wrap) {
+	bool same = std::is_same<Ratio<int>, Ratio<int, overflow::Wrap>>::value ;
+	ASSERT_EQ (same, true);
+}
+
+TEST (RatioOverflow, checked) {
+	Ratio<int, overflow::Checked> r1(1000000,3);
+	Ratio<int, overflow::Checked> r2(3000,7);
+	Ratio<int, overflow::Checked> r3(2,3);
+
+	ASSERT_THROW (r1 * r2, std::overflow_error);
+	ASSERT_NO_THROW (r3 * r3);
+	ASSERT_EQ ((r3 * r3).get_numerator(), 4);
+}
+
+TEST (RatioOverflow, saturate) {
+	Ratio<int, overflow::Saturate> r1(1000000,3);
+	Ratio<int, overflow::Saturate> r2(3000,7);
+
+	Ratio<int, overflow::Saturate> r3 = r1 * r2;
+	ASSERT_EQ (r3.get_denominator(), 0);
+	ASSERT_EQ (r3 == (Ratio<int, overflow::Saturate>::inf()), true);
+}
+
+TEST (RatioOverflow, promote) {
+	Ratio<int, overflow::Promote> r1(1000000,3);
+	Ratio<int, overflow::Promote> r2(3000,1000001);
+	Ratio<int, overflow::Promote> r3(30000,7);
+
+	// the intermediate numerator 3e9 does not fit in an int, but the reduced result does
+	Ratio<int, overflow::Promote> r4 = r1 * r2;
+	ASSERT_EQ (r4.get_numerator(), 1000000000);
+	ASSERT_EQ (r4.get_denominator(), 1000001);
+
+	ASSERT_THROW (r1 * r3, std::overflow_error);
+}
+
+
+/*------------------- FLOATING POINT CONVERSION ---------------------*/
+
+TEST (RatioConversion, to_double_fast_path) {
+	Ratio<long int> r(1,3);
+	Ratio<long int> inf = Ratio<long int>::inf();
+
+	ASSERT_EQ (r.to_double(), 1.0/3.0);
+	ASSERT_EQ (Ratio<int>(-22,7).to_double(), -22.0/7.0);
+	ASSERT_EQ (inf.to_double(), std::numeric_limits<double>::infinity());
+}
+
+TEST (RatioConversion, to_double_correctly_rounded) {
+	// (2^53+1)/(2^53+3) : converting both parts to double before dividing gives a wrong last bit
+	Ratio<long int> r((1L<<53)+1, (1L<<53)+3);
+	ASSERT_EQ (r.to_double(), 1.0 - std::ldexp(1.0, -52));
+
+	Ratio<long int> big(-((1L<<62)+1), 3);
+	ASSERT_EQ (big.to_double(), -std::ldexp(1.0, 62)/3.0);
+}
+
+TEST (RatioConversion, to_float_correctly_rounded) {
+	Ratio<long int> r((1L<<24)+1, (1L<<24)+3);
+	ASSERT_EQ (r.to_float(), 1.0f - std::ldexp(1.0f, -23));
+
+	Ratio<int> small(2,3);
+	ASSERT_EQ (small.to_float(), 2.0f/3.0f);
+}
+
+#if defined(RATIO_HAS_INT128_TRAITS)
+TEST (RatioConversion, to_float_subnormal) {
+	// 1/d is close to the midpoint (2^23+3)/2^150 of 2 subnormal floats, between 4194305 and 4194306 times 2^-149 :
+	// it is above for d <= d0 = floor(2^150/(2^23+3)), below after. The mantissa must be rounded once, at the subnormal ulp
+	const ratio_int128 k = (ratio_int128(1) << 23) + 3;
+	const ratio_int128 high = ratio_int128(1) << 126;
+	const ratio_int128 d0 = (high / k) * (ratio_int128(1) << 24) + ((high % k) << 24) / k;
+	const float below = std::ldexp(4194305.0f, -149), above = std::ldexp(4194306.0f, -149);
+	for(ratio_int128 d = d0 - 500; d <= d0 + 500; ++d){
+		ASSERT_EQ (Ratio<ratio_int128>(1, d).to_float(), (d <= d0) ? above : below);
+		ASSERT_EQ (Ratio<ratio_int128>(-1, d).to_float(), (d <= d0) ? -above : -below);
+	}
+	// d = 170141122613262181433646877826316554243
+	const ratio_int128 d = ratio_int128(17014112261326218143ull) * ratio_int128(10000000000000000000ull) + 3646877826316554243ll;
+	ASSERT_EQ (d, d0 + 3);
+	ASSERT_EQ (Ratio<ratio_int128>(1, d).to_float(), below);
+}
+#endif
+
+TEST (RatioConversion, to_double_batch) {
+	const size_t maxSize = 1L<<62;  
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> uniformIntDistribution(1,maxSize);
+	auto gen = [&uniformIntDistribution, &generator](){ return Ratio<long int>(uniformIntDistribution(generator), uniformIntDistribution(generator));};
+
+	const int nbTest = 100 ; 
+	std::vector<Ratio<long int>> data(nbTest);
+	std::generate(data.begin(), data.end(), gen);
+	data[0] = Ratio<long int>(1,7);
+
+	std::vector<double> result(nbTest);
+	Ratio<long int>::to_double(data.data(), data.size(), result.data());
+
+	for(int run=0; run<nbTest; ++run){
+		ASSERT_EQ (result[run], data[run].to_double());
+	}
+}
+
+
+/*------------------- FAREY SEQUENCE ---------------------*/
+
+TEST (Farey, sequence) {
+	const std::vector<Ratio<int>> expected = {{0,1}, {1,5}, {1,4}, {1,3}, {2,5}, {1,2}, {3,5}, {2,3}, {3,4}, {4,5}, {1,1}};
+	std::vector<Ratio<int>> result;
+	for(Ratio<int> r : FareySequence<int>(5)) result.push_back(r);
+
+	ASSERT_EQ (result.size(), expected.size());
+	for(size_t i=0; i<expected.size(); ++i){
+		ASSERT_EQ (result[i] == expected[i], true);
+	}
+}
+
+TEST (Farey, reverse_and_interval) {
+	FareySequence<long int> farey(5, Ratio<long int>(1,3), Ratio<long int>(2,3));
+	const std::vector<Ratio<long int>> expected = {{2,3}, {3,5}, {1,2}, {2,5}, {1,3}};
+
+	std::vector<Ratio<long int>> result(farey.rbegin(), farey.rend());
+	ASSERT_EQ (result.size(), expected.size());
+	for(size_t i=0; i<expected.size(); ++i){
+		ASSERT_EQ (result[i] == expected[i], true);
+	}
+}
+
+TEST (Farey, length_and_order) {
+	// |F_n| = 1 + phi(1) + ... + phi(n)
+	const int n = 100;
+	int length = 1;
+	for(int k=1; k<=n; ++k){
+		for(int j=1; j<=k; ++j) if(std::gcd(j,k) == 1) ++length;
+	}
+
+	int count = 0;
+	Ratio<int> previous(-1,1);
+	for(Ratio<int> r : FareySequence<int>(n)){
+		ASSERT_LE (r.get_denominator(), n);
+		ASSERT_EQ (previous < r, true);
+		previous = r;
+		++count;
+	}
+	ASSERT_EQ (count, length);
+}
+
+TEST (Farey, partition) {
+	const long int n = 60;
+	std::vector<Ratio<long int>> whole(FareySequence<long int>(n).begin(), FareySequence<long int>(n).end());
+
+	std::vector<Ratio<long int>> pieces;
+	for(const FareySequence<long int>& part : FareySequence<long int>::partition(n, 7)){
+		pieces.insert(pieces.end(), part.begin(), part.end());
+	}
+	ASSERT_EQ (pieces.size(), whole.size());
+	for(size_t i=0; i<whole.size(); ++i){
+		ASSERT_EQ (pieces[i] == whole[i], true);
+	}
+
+	std::atomic<long int> count(0);
+	FareySequence<long int>::for_each_parallel(n, [&count](Ratio<long int>){ ++count; }, 4);
+	ASSERT_EQ (count.load(), (long int)whole.size());
+}
+
+
+/*------------------- DENOMINATOR COMPACTION ---------------------*/
+
+TEST (RatioCompaction, limit_denominator) {
+	Ratio<long int> pi(314159265358979, 100000000000000);
+
+	ASSERT_EQ (pi.limit_denominator(10) == Ratio<long int>(22,7), true);
+	ASSERT_EQ (pi.limit_denominator(100) == Ratio<long int>(311,99), true);
+	ASSERT_EQ (pi.limit_denominator(1000) == Ratio<long int>(355,113), true);
+	ASSERT_EQ ((-pi).limit_denominator(1000) == Ratio<long int>(-355,113), true);
+	ASSERT_EQ (Ratio<long int>(1,3).limit_denominator(10) == Ratio<long int>(1,3), true);
+
+	// the numerator can be the minimum of the type
+	const Ratio<long int> lowest(std::numeric_limits<long int>::min(), 3, reduced_tag);
+	ASSERT_EQ (lowest.limit_denominator(2) == Ratio<long int>(-6148914691236517205, 2), true);
+	ASSERT_EQ (Ratio<int>(std::numeric_limits<int>::min(), 7, reduced_tag).limit_denominator(1) == Ratio<int>(-306783378), true);
+}
+
+TEST (RatioCompaction, limit_denominator_is_closest) {
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> uniformIntDistribution(1,1000);
+
+	const int nbTest = 100 ; 
+	for(int run=0; run<nbTest; ++run){
+		Ratio<long int> x(uniformIntDistribution(generator), uniformIntDistribution(generator));
+		const long int max_den = 1 + run % 30;
+		Ratio<long int> best = x.limit_denominator(max_den);
+		ASSERT_LE (best.get_denominator(), max_den);
+
+		// brute force : no ratio with a bounded denominator is closer
+		Ratio<long int> distance = (x - best).abs();
+		for(long int q=1; q<=max_den; ++q){
+			const long int p = (x.get_numerator()*q) / x.get_denominator();
+			for(long int candidate=p; candidate<=p+1; ++candidate){
+				ASSERT_EQ (distance <= (x - Ratio<long int>(candidate,q)).abs(), true);
+			}
+		}
+	}
+}
+
+TEST (RatioCompaction, simplest_between) {
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(3,10), Ratio<int>(35,100)) == Ratio<int>(1,3), true);
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(1,2), Ratio<int>(1,3)) == Ratio<int>(1,2), true);
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(5,2), Ratio<int>(7,2)) == Ratio<int>(3,1), true);
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(-1,2), Ratio<int>(1,3)) == Ratio<int>(0,1), true);
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(-35,100), Ratio<int>(-3,10)) == Ratio<int>(-1,3), true);
+	ASSERT_EQ (Ratio<int>::simplest_between(Ratio<int>(314,100), Ratio<int>(315,100)) == Ratio<int>(22,7), true);
+}
+
+TEST (RatioCompaction, compactor) {
+	const long int max_den = 1000;
+	DenominatorCompactor<long int> compact(max_den, 4);
+	Ratio<long int> harmonic = Ratio<long int>::zero();
+	double reference = 0.;
+
+	for(long int k=1; k<=200; ++k){
+		harmonic = harmonic + Ratio<long int>(1,k);
+		reference += 1.0/(double)k;
+		compact(harmonic);
+	}
+	ASSERT_GT (compact.nb_compactions(), 0u);
+	ASSERT_LE (std::abs(harmonic.to_double() - reference), compact.error_bound() + epsilon);
+}
+
+
+/*------------------- CONCURRENT ACCUMULATOR ---------------------*/
+
+TEST (RatioConcurrent, single_thread) {
+	ConcurrentRatioAccumulator<long int> acc(2);
+	Ratio<long int> expected = Ratio<long int>::zero();
+
+	for(long int k=1; k<=20; ++k){
+		acc.add(Ratio<long int>(1,k));
+		expected = expected + Ratio<long int>(1,k);
+	}
+	ASSERT_EQ (acc.total() == expected, true);
+
+	acc.reset();
+	ASSERT_EQ (acc.total() == Ratio<long int>::zero(), true);
+}
+
+TEST (RatioConcurrent, multi_thread) {
+	const int nbThreads = 4;
+	const int nbAdd = 10000;
+	ConcurrentRatioAccumulator<long int> acc(nbThreads);
+
+	std::vector<std::thread> threads;
+	for(int t=0; t<nbThreads; ++t){
+		threads.emplace_back([&acc, t](){
+			for(int i=0; i<nbAdd; ++i){
+				acc.add(Ratio<long int>(1, 2 + (i+t)%3));
+				if(i % 1000 == 0) acc.total();
+			}
+		});
+	}
+	for(std::thread& thread : threads) thread.join();
+
+	// each thread adds 1/2, 1/3 and 1/4 in turn
+	Ratio<long int> expected = Ratio<long int>::zero();
+	for(int t=0; t<nbThreads; ++t){
+		for(int i=0; i<nbAdd; ++i) expected = expected + Ratio<long int>(1, 2 + (i+t)%3);
+	}
+	ASSERT_EQ (acc.total() == expected, true);
+	ASSERT_EQ (acc.error_bound(), 0.0);
+}
+
+TEST (RatioConcurrent, compaction) {
+	// the harmonic sum overflows long int after about 40 terms without compaction ;
+	// with it, the denominators stay below max_den * k^2 between 2 compactions
+	const int nbThreads = 4;
+	const long int nbAdd = 5000;
+	const long int max_den = 1000000;
+	ConcurrentRatioAccumulator<long int> acc(nbThreads, DenominatorCompactor<long int>(max_den, 2));
+
+	std::vector<std::thread> threads;
+	for(int t=0; t<nbThreads; ++t){
+		threads.emplace_back([&acc, t](){
+			for(long int k=1+t; k<=nbAdd; k+=nbThreads) acc.add(Ratio<long int>(1, k));
+		});
+	}
+	for(std::thread& thread : threads) thread.join();
+
+	double harmonic = 0.0;
+	for(long int k=nbAdd; k>=1; --k) harmonic += 1.0 / static_cast<double>(k);
+	ASSERT_GT (acc.error_bound(), 0.0);
+	ASSERT_LE (std::abs(acc.total().to_double() - harmonic), acc.error_bound() + 1e-9);
+}
+
+TEST (RatioConcurrent, thread_churn) {
+	// a thread gives its shard back when it exits : short lived threads and several accumulators never share a shard
+	ConcurrentRatioAccumulator<long int> first(1), second(1);
+	Ratio<long int> expected = Ratio<long int>::zero();
+	for(long int k=1; k<=30; ++k){
+		std::thread thread([&first, &second, k](){
+			first.add(Ratio<long int>(1, 1 + k%5));
+			second.add(Ratio<long int>(k, 7));
+		});
+		thread.join();
+		expected = expected + Ratio<long int>(1, 1 + k%5);
+	}
+	ASSERT_EQ (first.total() == expected, true);
+	ASSERT_EQ (second.total() == Ratio<long int>(465, 7), true);
+
+	// more threads than shards : the extra ones share the spill shard
+	std::vector<std::thread> threads;
+	for(int t=0; t<4; ++t) threads.emplace_back([&second](){ for(int i=0; i<1000; ++i) second.add(Ratio<long int>(1, 7)); });
+	for(std::thread& thread : threads) thread.join();
+	ASSERT_EQ (second.total() == Ratio<long int>(4465, 7), true);
+}
+
+TEST (RatioConcurrent, overflow_and_reset) {
+	// the same denominator sum overflows : the shard falls back to the addition of Ratio and its overflow policy
+	ConcurrentRatioAccumulator<long int> acc(1);
+	const long int big = std::numeric_limits<long int>::max() / 2 + 2;
+	acc.add(Ratio<long int>(big, 2));
+	acc.add(Ratio<long int>(big, 2));
+	ASSERT_EQ (acc.total() == Ratio<long int>(big, 2) + Ratio<long int>(big, 2), true);
+
+	ConcurrentRatioAccumulator<long int> compacted(1, DenominatorCompactor<long int>(100, 1));
+	for(long int k=1; k<=20; ++k) compacted.add(Ratio<long int>(1, k));
+	ASSERT_GT (compacted.error_bound(), 1.0 / 200.0);
+	compacted.reset();
+	ASSERT_EQ (compacted.total() == Ratio<long int>::zero(), true);
+	ASSERT_EQ (compacted.error_bound(), 1.0 / 100.0);
+}
+
+
+/*------------------- STREAMING STATISTICS ---------------------*/
+
+TEST (RatioStatistics, compare) {
+	ASSERT_LT (Ratio<long int>::compare(Ratio<long int>(1,3), Ratio<long int>(1,2)), 0);
+	ASSERT_GT (Ratio<long int>::compare(Ratio<long int>(-1,3), Ratio<long int>(-1,2)), 0);
+	ASSERT_EQ (Ratio<long int>::compare(Ratio<long int>(2,4), Ratio<long int>(1,2)), 0);
+	// the cross products overflow a long int, not the wide type
+	ASSERT_LT (Ratio<long int>::compare(Ratio<long int>(4000000000001,4000000000000), Ratio<long int>(4000000000000,3999999999999)), 0);
+}
+
+TEST (RatioStatistics, mean_variance) {
+	RatioStats<long int> stats;
+	stats.add(Ratio<long int>(1,2));
+	stats.add(Ratio<long int>(1,3));
+	stats.add(Ratio<long int>(1,6));
+
+	ASSERT_EQ (stats.count(), 3u);
+	ASSERT_EQ (stats.sum() == Ratio<long int>(1,1), true);
+	ASSERT_EQ (stats.mean() == Ratio<long int>(1,3), true);
+	ASSERT_EQ (stats.variance() == Ratio<long int>(1,54), true);
+	ASSERT_EQ (stats.sample_variance() == Ratio<long int>(1,36), true);
+	ASSERT_EQ (stats.min() == Ratio<long int>(1,6), true);
+	ASSERT_EQ (stats.max() == Ratio<long int>(1,2), true);
+}
+
+TEST (RatioStatistics, merge) {
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> numDistribution(-100,100);
+	std::uniform_int_distribution<long int> denDistribution(1,12);
+
+	const int nbTest = 1000 ; 
+	RatioStats<long int> all, first, second;
+	Ratio<long int> sum = Ratio<long int>::zero();
+	for(int run=0; run<nbTest; ++run){
+		Ratio<long int> r(numDistribution(generator), denDistribution(generator));
+		all.add(r);
+		if(run % 3 == 0) first.add(r);
+		else second.add(r);
+		sum = sum + r;
+	}
+	first.merge(second);
+
+	ASSERT_EQ (all.sum() == sum, true);
+	ASSERT_EQ (first.count(), all.count());
+	ASSERT_EQ (first.mean() == all.mean(), true);
+	ASSERT_EQ (first.variance() == all.variance(), true);
+	ASSERT_EQ (first.min() == all.min(), true);
+	ASSERT_EQ (first.max() == all.max(), true);
+}
+
+TEST (RatioStatistics, overflow) {
+	// n^2 D^2 does not fit in the wide type, the variance 1/10007^2 does
+	RatioStats<int> stats;
+	for(int i=0; i<200000; ++i){
+		stats.add(Ratio<int>(1,10007));
+		stats.add(Ratio<int>(3,10007));
+	}
+	ASSERT_EQ (stats.mean() == Ratio<int>(2,10007), true);
+	ASSERT_EQ (stats.variance() == Ratio<int>(1,100140049), true);
+
+	// the lcm of the denominators overflows the wide type
+	RatioStats<int> primes;
+	primes.add(Ratio<int>(1,2147483647));
+	primes.add(Ratio<int>(1,2147483629));
+	ASSERT_THROW (primes.add(Ratio<int>(1,2147483587)), std::overflow_error);
+
+	// the sum does not fit in an int
+	RatioStats<int> large;
+	large.add(Ratio<int>(2147483647));
+	large.add(Ratio<int>(2147483647));
+	ASSERT_THROW (large.sum(), std::overflow_error);
+}
+
+
+/*------------------- COMMON DENOMINATOR VECTOR ---------------------*/
+
+TEST (CommonDenominator, push_and_rescale) {
+	CommonDenomVector<long int> prices(10000);
+	prices.push_back(Ratio<long int>(1,4));
+	prices.push_back(Ratio<long int>(3,10000));
+	ASSERT_EQ (prices.denominator(), 10000);
+	ASSERT_EQ (prices.numerators()[0], 2500);
+	ASSERT_EQ (prices.numerators()[1], 3);
+
+	// 1/3 does not fit the grid : the whole vector goes to lcm(10000,3)
+	prices.push_back(Ratio<long int>(1,3));
+	ASSERT_EQ (prices.denominator(), 30000);
+	ASSERT_EQ (prices[0] == Ratio<long int>(1,4), true);
+	ASSERT_EQ (prices[1] == Ratio<long int>(3,10000), true);
+	ASSERT_EQ (prices[2] == Ratio<long int>(1,3), true);
+	ASSERT_EQ (prices.sum() == Ratio<long int>(1,4) + Ratio<long int>(3,10000) + Ratio<long int>(1,3), true);
+}
+
+TEST (CommonDenominator, arithmetic) {
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> uniformIntDistribution(-1000,1000);
+
+	const int nbTest = 100 ; 
+	CommonDenomVector<long int> v1(nbTest, 6), v2(nbTest, 10);
+	for(int run=0; run<nbTest; ++run){
+		v1.set(run, Ratio<long int>(uniformIntDistribution(generator), 6));
+		v2.set(run, Ratio<long int>(uniformIntDistribution(generator), 10));
+	}
+
+	CommonDenomVector<long int> add = v1 + v2;
+	CommonDenomVector<long int> sub = v1 - v2;
+	ASSERT_EQ (add.denominator(), 30);
+	for(int run=0; run<nbTest; ++run){
+		ASSERT_EQ (add[run] == v1[run] + v2[run], true);
+		ASSERT_EQ (sub[run] == v1[run] - v2[run], true);
+	}
+
+	v1 *= 6;
+	v1.compact();
+	ASSERT_EQ (v1.denominator(), 1);
+}
+
+TEST (CommonDenominator, overflow) {
+	// lcm(2147483647, 2147483629) does not fit in an int
+	CommonDenomVector<int> v(2147483647);
+	v.push_back(Ratio<int>(1,2147483647));
+	ASSERT_THROW (v.push_back(Ratio<int>(1,2147483629)), std::overflow_error);
+
+	CommonDenomVector<int> w(1);
+	w.push_back(Ratio<int>(2000000000));
+	w.push_back(Ratio<int>(2000000000));
+	ASSERT_THROW (w.sum(), std::overflow_error);
+	ASSERT_THROW (w += w, std::overflow_error);
+
+	// the numerators do not fit in an int over the denominator 3
+	CommonDenomVector<int> x(1);
+	x.push_back(Ratio<int>(2000000000));
+	ASSERT_THROW (x.push_back(Ratio<int>(1,3)), std::overflow_error);
+	CommonDenomVector<int> y(1);
+	y.push_back(Ratio<int>(2000000000));
+	ASSERT_THROW (y *= 2, std::overflow_error);
+	ASSERT_EQ (y[0] == Ratio<int>(2000000000), true);
+
+	// the sum is exact as long as the result fits, whatever the order of the elements
+	CommonDenomVector<int> z(1);
+	z.push_back(Ratio<int>(2000000000));
+	z.push_back(Ratio<int>(2000000000));
+	z.push_back(Ratio<int>(-2000000000));
+	z.push_back(Ratio<int>(-7));
+	ASSERT_EQ (z.sum() == Ratio<int>(1999999993), true);
+	CommonDenomVector<int> minus(1);
+	minus.push_back(Ratio<int>(-2000000000));
+	CommonDenomVector<int> plus(1);
+	plus.push_back(Ratio<int>(2000000000));
+	ASSERT_THROW (minus -= plus, std::overflow_error);
+}
+
+
+/*------------------- FIXED DENOMINATOR ---------------------*/
+
+TEST (FixedDenominator, rounding) {
+	ASSERT_EQ (rounded_division(7, 2, Rounding::toward_zero), 3);
+	ASSERT_EQ (rounded_division(-7, 2, Rounding::down), -4);
+	ASSERT_EQ (rounded_division(-7, 2, Rounding::up), -3);
+	ASSERT_EQ (rounded_division(7, 2, Rounding::nearest), 4);
+	ASSERT_EQ (rounded_division(-7, 2, Rounding::nearest), -4);
+	ASSERT_EQ (rounded_division(7, 2, Rounding::half_even), 4);
+	ASSERT_EQ (rounded_division(5, 2, Rounding::half_even), 2);
+	ASSERT_EQ (rounded_division(-5, 2, Rounding::half_even), -2);
+	ASSERT_EQ (rounded_division(8, 3, Rounding::half_even), 3);
+}
+
+TEST (FixedDenominator, arithmetic) {
+	using Money = Fixed<long int, 100>;
+	Money price = Money::from_numerator(1999);
+	Money tax(Ratio<long int>(1,5));
+
+	ASSERT_EQ ((price + tax).numerator(), 2019);
+	ASSERT_EQ ((price - tax).numerator(), 1979);
+	ASSERT_EQ ((price * 3L).numerator(), 5997);
+	// 19.99 * 0.20 = 3.998
+	ASSERT_EQ ((price * tax).numerator(), 400);
+	ASSERT_EQ (Money::multiply(price, tax, Rounding::down).numerator(), 399);
+	// 19.99 / 3 = 6.6633...
+	ASSERT_EQ ((price / 3L).numerator(), 666);
+	ASSERT_EQ (Money::divide(price, 3L, Rounding::up).numerator(), 667);
+	ASSERT_EQ ((price / tax).numerator(), 9995);
+	ASSERT_EQ (tax < price, true);
+}
+
+TEST (FixedDenominator, ratio_conversion) {
+	using Money = Fixed<long int, 100>;
+	ASSERT_EQ (Money(Ratio<long int>(3,4)).to_ratio() == Ratio<long int>(3,4), true);
+	ASSERT_EQ (Money::from_ratio(Ratio<long int>(1,3)).numerator(), 33);
+	ASSERT_EQ (Money::from_ratio(Ratio<long int>(2,3)).numerator(), 67);
+	ASSERT_EQ (Money::from_ratio(Ratio<long int>(2,3), Rounding::toward_zero).numerator(), 66);
+
+	// the product of the numerators overflows a long int, the wide type is used
+	using Tick = Fixed<long int, 90000>;
+	Tick big = Tick::from_numerator(4000000000000000);
+	ASSERT_EQ ((big * Tick(2L)).numerator(), 8000000000000000);
+
+	// the numerators do not fit in a long int
+	ASSERT_THROW (Tick(200000000000000L), std::overflow_error);
+	ASSERT_THROW (Tick(Ratio<long int>(400000000000000L,3)), std::overflow_error);
+	ASSERT_THROW (Tick::from_ratio(Ratio<long int>(800000000000000L,7)), std::overflow_error);
+	ASSERT_THROW (big * big, std::overflow_error);
+	ASSERT_THROW (big / Tick::from_numerator(1), std::overflow_error);
+
+	// the additive operators are checked too
+	const Tick top = Tick::from_numerator(std::numeric_limits<long int>::max());
+	const Tick bottom = Tick::from_numerator(std::numeric_limits<long int>::min());
+	ASSERT_THROW (top + Tick::from_numerator(1), std::overflow_error);
+	ASSERT_THROW (bottom - Tick::from_numerator(1), std::overflow_error);
+	ASSERT_THROW (-bottom, std::overflow_error);
+	ASSERT_THROW (2L * top, std::overflow_error);
+	ASSERT_THROW (bottom / -1L, std::overflow_error);
+	Tick sum = top;
+	ASSERT_THROW (sum += top, std::overflow_error);
+	ASSERT_EQ (sum == top, true);
+	ASSERT_EQ ((-top).numerator(), -std::numeric_limits<long int>::max());
+}
+
+
+/*------------------- RATIO INDEX ---------------------*/
+
+TEST (RatioIndexSearch, bounds) {
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> numDistribution(-50,50);
+	std::uniform_int_distribution<long int> denDistribution(1,10);
+	auto gen = [&](){ return Ratio<long int>(numDistribution(generator), denDistribution(generator));};
+
+	const int nbTest = 200 ; 
+	std::vector<std::pair<Ratio<long int>, int>> entries;
+	for(int run=0; run<nbTest; ++run) entries.push_back(std::make_pair(gen(), run));
+	RatioIndex<long int, int> index(entries);
+
+	std::vector<Ratio<long int>> keys;
+	for(const auto& entry : entries) keys.push_back(entry.first);
+	std::sort(keys.begin(), keys.end());
+
+	ASSERT_EQ (index.size(), keys.size());
+	for(int run=0; run<nbTest; ++run){
+		Ratio<long int> key = gen();
+		ASSERT_EQ (index.lower_bound(key), (size_t)(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin()));
+		ASSERT_EQ (index.upper_bound(key), (size_t)(std::upper_bound(keys.begin(), keys.end(), key) - keys.begin()));
+	}
+}
+
+TEST (RatioIndexSearch, range_and_insert) {
+	RatioIndex<int, std::string> index({{Ratio<int>(1,2), "half"}, {Ratio<int>(1,3), "third"}, {Ratio<int>(3,4), "three quarters"}});
+	index.insert({{Ratio<int>(2,3), "two thirds"}, {Ratio<int>(1,10), "tenth"}, {Ratio<int>(1,2), "other half"}});
+
+	std::vector<std::string> found;
+	index.for_each_in(Ratio<int>(1,3), Ratio<int>(2,3), [&found](const Ratio<int>&, const std::string& v){ found.push_back(v); });
+	const std::vector<std::string> expected = {"third", "half", "other half", "two thirds"};
+	ASSERT_EQ (found, expected);
+
+	index.erase(Ratio<int>(1,2), Ratio<int>(1,2));
+	ASSERT_EQ (index.size(), 4u);
+	ASSERT_EQ (index.value(0), "tenth");
+	ASSERT_EQ (index.value(3), "three quarters");
+}
+
+
+/*------------------- BUCKETED SUM ---------------------*/
+
+TEST (BucketedSummation, array) {
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> numDistribution(-1000,1000);
+	const long int denominators[] = {2, 4, 100, 3, 7};
+
+	const int nbTest = 1000 ; 
+	std::vector<Ratio<long int>> data(nbTest);
+	Ratio<long int> expected = Ratio<long int>::zero();
+	for(int run=0; run<nbTest; ++run){
+		data[run] = Ratio<long int>(numDistribution(generator), denominators[run % 5]);
+		expected = expected + data[run];
+	}
+
+	ASSERT_EQ (bucketed_sum(data.begin(), data.end()) == expected, true);
+	ASSERT_EQ (bucketed_sum(data.data(), data.size()) == expected, true);
+}
+
+TEST (BucketedSummation, stream) {
+	BucketedSum<int> sum;
+	for(int k=1; k<=10; ++k){
+		sum.add(Ratio<int>(1,2));
+		sum.add(Ratio<int>(k,4));
+	}
+	// some ratios are reduced to other denominators : 2/4, 4/4...
+	ASSERT_LE (sum.nb_buckets(), 3u);
+	ASSERT_EQ (sum.result() == Ratio<int>(5,1) + Ratio<int>(55,4), true);
+}
+
+TEST (BucketedSummation, overflow) {
+	// the result keeps the policy of the ratios
+	using Checked = Ratio<int, overflow::Checked>;
+	using Saturate = Ratio<int, overflow::Saturate>;
+	const Checked exact[] = {Checked(1,3), Checked(1,6)};
+	static_assert(std::is_same<decltype(bucketed_sum(exact, 2)), Checked>::value, "the policy is kept");
+	ASSERT_EQ (bucketed_sum(exact, 2) == Checked(1,2), true);
+
+	// the sum does not fit in an int
+	const Checked large[] = {Checked(2000000000), Checked(2000000000)};
+	ASSERT_THROW (bucketed_sum(large, 2), std::overflow_error);
+	const Saturate saturated[] = {Saturate(2000000000), Saturate(2000000000)};
+	ASSERT_EQ (bucketed_sum(saturated, 2).get_denominator(), 0);
+
+	// the lcm of the denominators overflows the wide type
+	BucketedSum<int> sum;
+	sum.add(Ratio<int>(1,2147483647));
+	sum.add(Ratio<int>(1,2147483629));
+	sum.add(Ratio<int>(1,2147483587));
+	ASSERT_THROW (sum.result(), std::overflow_error);
+	ASSERT_EQ (sum.result<overflow::Saturate>().get_denominator(), 0);
+}
+
+
+/*------------------- SIMPLEX ---------------------*/
+
+TEST (SimplexSolver, optimum) {
+	// maximize 3x + 5y subject to x <= 4, 2y <= 12, 3x + 2y <= 18
+	using R = Simplex<long int>::ratio_type;
+	const std::vector<std::vector<R>> A = {{R(1), R(0)}, {R(0), R(2)}, {R(3), R(2)}};
+	const Simplex<long int> lp(A, {R(4), R(12), R(18)}, {R(3), R(5)});
+
+	for(PivotRule rule : {PivotRule::bland, PivotRule::dantzig, PivotRule::steepest_edge}){
+		for(std::size_t nb_threads : {1u, 2u}){
+			SimplexOptions options;
+			options.rule = rule;
+			options.nb_threads = nb_threads;
+			options.fraction_free = (nb_threads == 2u);
+			const auto result = lp.maximize(options);
+			ASSERT_EQ (result.status == SimplexStatus::optimal, true);
+			ASSERT_EQ (result.value == R(36), true);
+			ASSERT_EQ (result.solution[0] == R(2), true);
+			ASSERT_EQ (result.solution[1] == R(6), true);
+		}
+	}
+
+	// fractional optimum : maximize x + y subject to 2x + y <= 1, x + 3y <= 1
+	using Q = Simplex<int>::ratio_type;
+	const Simplex<int> fractional(std::vector<std::vector<Q>>{{Q(2), Q(1)}, {Q(1), Q(3)}}, {Q(1), Q(1)}, {Q(1), Q(1)});
+	const auto result = fractional.maximize();
+	ASSERT_EQ (result.value == Q(3,5), true);
+	ASSERT_EQ (result.solution[0] == Q(2,5), true);
+	ASSERT_EQ (result.solution[1] == Q(1,5), true);
+}
+
+TEST (SimplexSolver, steepest_edge_measures) {
+	// maximize 1000x + 999y subject to 100x + 99y <= 1 : the measures 10^6/10001 and 998001/9802 fit in an int,
+	// the cross products of their numerators and denominators do not
+	using R = Simplex<int>::ratio_type;
+	const std::vector<std::vector<R>> A = {{R(100), R(99)}};
+	const Simplex<int> lp(A, {R(1)}, {R(1000), R(999)});
+	SimplexOptions options;
+	options.rule = PivotRule::steepest_edge;
+	const auto result = lp.maximize(options);
+	ASSERT_EQ (result.status == SimplexStatus::optimal, true);
+	ASSERT_EQ (result.value == R(111,11), true);
+	ASSERT_EQ (result.solution[1] == R(1,99), true);
+}
+
+TEST (SimplexSolver, parallel_search) {
+	// each constraint bounds its own block of variables, the optimum takes the best cost per unit of each block :
+	// the steepest edge search reads enough cells per pivot to be split between the threads
+	using R = Simplex<long int>::ratio_type;
+	const std::size_t m = 20, n = 400;
+	std::mt19937 generator(3);
+	std::uniform_int_distribution<long int> distribution(1,9);
+	std::vector<std::vector<R>> A(m, std::vector<R>(n, R(0)));
+	std::vector<R> b(m), c(n);
+	for(std::size_t j=0; j<n; ++j) c[j] = R(distribution(generator));
+	R expected = R(0);
+	for(std::size_t i=0; i<m; ++i){
+		b[i] = R(distribution(generator));
+		R best = R(0);
+		for(std::size_t j=i; j<n; j+=m){
+			A[i][j] = R(distribution(generator));
+			if(c[j] / A[i][j] > best) best = c[j] / A[i][j];
+		}
+		expected += b[i] * best;
+	}
+	ASSERT_GE ((n + m + 1) * (m + 1), 2 * Simplex<long int>::min_work_per_thread);
+
+	const Simplex<long int> lp(A, b, c);
+	for(std::size_t nb_threads : {1u, 2u, 4u}){
+		SimplexOptions options;
+		options.rule = PivotRule::steepest_edge;
+		options.nb_threads = nb_threads;
+		const auto result = lp.maximize(options);
+		ASSERT_EQ (result.status == SimplexStatus::optimal, true);
+		ASSERT_EQ (result.value == expected, true);
+	}
+}
+
+TEST (SimplexSolver, phase_one) {
+	using R = Simplex<long int>::ratio_type;
+	using Matrix = std::vector<std::vector<R>>;
+	using Vector = std::vector<R>;
+	// maximize -x - y subject to x + y >= 3/2 (-x - y <= -3/2), x <= 1
+	const Simplex<long int> lp(Matrix{{R(-1), R(-1)}, {R(1), R(0)}}, Vector{R(-3,2), R(1)}, Vector{R(-1), R(-1)});
+	const auto result = lp.maximize();
+	ASSERT_EQ (result.status == SimplexStatus::optimal, true);
+	ASSERT_EQ (result.value == R(-3,2), true);
+	ASSERT_EQ (result.solution[0] + result.solution[1] == R(3,2), true);
+
+	// x <= 1 and x >= 2
+	const Simplex<long int> infeasible(Matrix{{R(1)}, {R(-1)}}, Vector{R(1), R(-2)}, Vector{R(1)});
+	ASSERT_EQ (infeasible.maximize().status == SimplexStatus::infeasible, true);
+
+	// maximize x subject to x - y <= 1
+	const Simplex<long int> unbounded(Matrix{{R(1), R(-1)}}, Vector{R(1)}, Vector{R(1), R(0)});
+	ASSERT_EQ (unbounded.maximize().status == SimplexStatus::unbounded, true);
+}
+
+TEST (SimplexSolver, warm_start) {
+	using R = Simplex<long int>::ratio_type;
+	const std::vector<std::vector<R>> A = {{R(1), R(0)}, {R(0), R(2)}, {R(3), R(2)}};
+	const auto first = Simplex<long int>(A, {R(4), R(12), R(18)}, {R(3), R(5)}).maximize();
+
+	// same basis, slightly moved right-hand side
+	SimplexOptions options;
+	options.warm_basis = first.basis;
+	const auto second = Simplex<long int>(A, {R(4), R(12), R(19)}, {R(3), R(5)}).maximize(options);
+	ASSERT_EQ (second.status == SimplexStatus::optimal, true);
+	ASSERT_EQ (second.value == R(37), true);
+	ASSERT_EQ (second.solution[0] == R(7,3), true);
+	ASSERT_LE (second.nb_pivots, first.nb_pivots);
+
+	// an infeasible warm basis is dropped
+	options.warm_basis = {0, 1, 2};
+	ASSERT_EQ (Simplex<long int>(A, {R(4), R(12), R(18)}, {R(3), R(5)}).maximize(options).value == R(36), true);
+}
+
+TEST (SimplexSolver, fraction_free) {
+	// the integer tableau gives the same optimum as the tableau of ratios, with fractional data, a phase 1 and a warm start
+	using R = Simplex<long int>::ratio_type;
+	using Matrix = std::vector<std::vector<R>>;
+	using Vector = std::vector<R>;
+	std::mt19937 generator(5);
+	std::uniform_int_distribution<long int> numDistribution(-9,9);
+	std::uniform_int_distribution<long int> denDistribution(1,6);
+	auto gen = [&](){ return R(numDistribution(generator), denDistribution(generator)); };
+
+	for(int test=0; test<20; ++test){
+		const std::size_t m = 6, n = 5;
+		Matrix A(m, Vector(n));
+		Vector b(m), c(n);
+		for(std::size_t i=0; i<m; ++i){
+			for(std::size_t j=0; j<n; ++j) A[i][j] = gen();
+			// a few constraints x_j >= ... make the slack basis infeasible
+			b[i] = (i < 2) ? gen() : R(std::abs(numDistribution(generator)) + 1, denDistribution(generator));
+		}
+		for(std::size_t j=0; j<n; ++j) c[j] = gen();
+		const Simplex<long int> lp(A, b, c);
+
+		for(PivotRule rule : {PivotRule::bland, PivotRule::dantzig, PivotRule::steepest_edge}){
+			SimplexOptions options;
+			options.rule = rule;
+			const auto expected = lp.maximize(options);
+			options.fraction_free = true;
+			const auto result = lp.maximize(options);
+			ASSERT_EQ (result.status == expected.status, true);
+			if(expected.status != SimplexStatus::optimal) continue;
+			ASSERT_EQ (result.value == expected.value, true);
+			R objective = R(0);
+			for(std::size_t j=0; j<n; ++j) objective += c[j] * result.solution[j];
+			ASSERT_EQ (objective == expected.value, true);
+
+			options.warm_basis = expected.basis;
+			const auto warm = lp.maximize(options);
+			ASSERT_EQ (warm.value == expected.value, true);
+			ASSERT_LE (warm.nb_pivots, expected.nb_pivots);
+		}
+	}
+
+	const Simplex<long int> infeasible(Matrix{{R(1)}, {R(-1)}}, Vector{R(1), R(-2)}, Vector{R(1)});
+	const Simplex<long int> unbounded(Matrix{{R(1), R(-1)}}, Vector{R(1)}, Vector{R(1), R(0)});
+	SimplexOptions options;
+	options.fraction_free = true;
+	ASSERT_EQ (infeasible.maximize(options).status == SimplexStatus::infeasible, true);
+	ASSERT_EQ (unbounded.maximize(options).status == SimplexStatus::unbounded, true);
+}
+
+
+/*------------------- CONTINUED FRACTION ---------------------*/
+
+TEST (ContinuedFractions, expansion) {
+	const std::vector<long int> expected = {4, 2, 6, 7};
+	const auto quotients = to_continued_fraction(Ratio<long int>(415,93));
+	ASSERT_EQ (std::vector<long int>(quotients.begin(), quotients.end()), expected);
+
+	// a0 is the floor : -415/93 = [-5; 1, 1, 6, 7]
+	const std::vector<long int> negative = {-5, 1, 1, 6, 7};
+	const auto negative_quotients = to_continued_fraction(Ratio<long int>(-415,93));
+	ASSERT_EQ (std::vector<long int>(negative_quotients.begin(), negative_quotients.end()), negative);
+
+	const std::vector<int> integer = {3};
+	const auto integer_quotients = to_continued_fraction(Ratio<int>(3));
+	ASSERT_EQ (std::vector<int>(integer_quotients.begin(), integer_quotients.end()), integer);
+}
+
+TEST (ContinuedFractions, round_trip) {
+	std::mt19937 generator(0);
+	std::uniform_int_distribution<long int> numDistribution(-1000000,1000000);
+	std::uniform_int_distribution<long int> denDistribution(1,1000000);
+
+	const int nbTest = 1000 ; 
+	for(int run=0; run<nbTest; ++run){
+		const Ratio<long int> r(numDistribution(generator), denDistribution(generator));
+		ASSERT_EQ (from_continued_fraction(to_continued_fraction(r)) == r, true);
+	}
+	ASSERT_EQ (from_continued_fraction(std::vector<int>{1, 2, 2, 2, 2}) == Ratio<int>(41,29), true);
+}
+
+TEST (ContinuedFractions, convergents) {
+	// 355/113 = [3; 7, 16], convergents 3, 22/7, 355/113
+	const std::vector<Ratio<int>> expected = {Ratio<int>(3), Ratio<int>(22,7), Ratio<int>(355,113)};
+	std::vector<Ratio<int>> found;
+	for(const Ratio<int>& c : convergents(Ratio<int>(355,113))) found.push_back(c);
+	ASSERT_EQ (found.size(), expected.size());
+	for(size_t i=0; i<found.size(); ++i) ASSERT_EQ (found[i] == expected[i], true);
+
+	// stop as soon as the convergent is within 1e-4 of sqrt(2) = [1; 2, 2, 2, ...]
+	const std::vector<long int> sqrt2 = {1, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+	Ratio<long int> approximation;
+	for(const Ratio<long int>& c : convergents(sqrt2.begin(), sqrt2.end())){
+		approximation = c;
+		if(std::abs(c.to_double() - std::sqrt(2.0)) < 1e-4) break;
+	}
+	ASSERT_EQ (approximation == Ratio<long int>(99,70), true);
+}
+
+
+/*------------------- MULTI-MODULAR ---------------------*/
+
+TEST (MultiModular, field) {
+	ASSERT_EQ (modular::prime(0), (uint64_t(1) << 63) - 25);
+	const modular::Field field(modular::prime(1));
+	std::mt19937_64 generator(0);
+	for(int run=0; run<1000; ++run){
+		const uint64_t a = generator() % field.modulus(), b = generator() % field.modulus();
+		const uint64_t expected = static_cast<uint64_t>(static_cast<ratio_uint128>(a) * b % field.modulus());
+		ASSERT_EQ (field.to_unsigned(field.mul(field.from_unsigned(a), field.from_unsigned(b))), expected);
+	}
+	uint64_t x = 0;
+	ASSERT_EQ (field.from_ratio(Ratio<long int>(-3,7), x), true);
+	ASSERT_EQ (field.mul(x, field.from_integer(7)), field.from_integer(-3));
+}
+
+TEST (MultiModular, determinant) {
+	// Hilbert matrix 5x5 : det = 1/266716800000
+	std::vector<std::vector<Ratio<long int>>> H(5, std::vector<Ratio<long int>>(5));
+	for(int i=0; i<5; ++i) for(int j=0; j<5; ++j) H[i][j] = Ratio<long int>(1, i+j+1);
+	ASSERT_EQ (modular::determinant(H) == Ratio<long int>(1, 266716800000), true);
+	ASSERT_EQ (modular::determinant(H, 3) == Ratio<long int>(1, 266716800000), true);
+
+	// singular matrix
+	const std::vector<std::vector<Ratio<int>>> S = {{Ratio<int>(1), Ratio<int>(2)}, {Ratio<int>(2), Ratio<int>(4)}};
+	ASSERT_EQ (modular::determinant(S) == Ratio<int>(0), true);
+
+	// 2^40 * 2^40 * 2^40 does not fit in a long int, but in a 128 bits integer
+	const long int big = 1L << 40;
+	const std::vector<std::vector<Ratio<long int>>> D = {{Ratio<long int>(big), Ratio<long int>(0), Ratio<long int>(0)}, {Ratio<long int>(1), Ratio<long int>(big), Ratio<long int>(0)}, {Ratio<long int>(0), Ratio<long int>(1), Ratio<long int>(-big)}};
+	const Ratio<ratio_int128> det = modular::determinant<ratio_int128>(D);
+	ASSERT_EQ (det.get_numerator() == -(static_cast<ratio_int128>(1) << 120), true);
+	ASSERT_EQ (det.get_denominator() == 1, true);
+	ASSERT_THROW (modular::determinant(D), std::overflow_error);
+}
+
+TEST (MultiModular, solve) {
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<long int> distribution(-9,9);
+	const std::size_t n = 40;
+
+	// A random, x known, b = A.x
+	std::vector<std::vector<Ratio<long int>>> A(n, std::vector<Ratio<long int>>(n));
+	std::vector<Ratio<long int>> expected(n), b(n, Ratio<long int>(0));
+	for(std::size_t j=0; j<n; ++j) expected[j] = Ratio<long int>(distribution(generator), 1 + std::abs(distribution(generator)));
+	for(std::size_t i=0; i<n; ++i){
+		for(std::size_t j=0; j<n; ++j){
+			A[i][j] = Ratio<long int>(distribution(generator));
+			b[i] = b[i] + A[i][j] * expected[j];
+		}
+	}
+
+	for(std::size_t nb_threads : {1u, 4u}){
+		std::vector<Ratio<long int>> x;
+		ASSERT_EQ (modular::solve(A, b, x, nb_threads), true);
+		for(std::size_t j=0; j<n; ++j) ASSERT_EQ (x[j] == expected[j], true);
+	}
+
+	std::vector<Ratio<int>> x;
+	const std::vector<std::vector<Ratio<int>>> S = {{Ratio<int>(1), Ratio<int>(2)}, {Ratio<int>(2), Ratio<int>(4)}};
+	ASSERT_EQ (modular::solve(S, std::vector<Ratio<int>>{Ratio<int>(1), Ratio<int>(2)}, x), false);
+}
+
+
+/*------------------- GEOMETRY ---------------------*/
+
+TEST (GeometryKernel, orientation) {
+	using P = geometry::Point<long int>;
+	// collinear with coordinates that are not exact doubles : decided by the exact evaluation
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(1,3), Ratio<long int>(1,7)}, P{Ratio<long int>(2,3), Ratio<long int>(2,7)}, P{Ratio<long int>(1), Ratio<long int>(3,7)}), 0);
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(1), Ratio<long int>(0)}, P{Ratio<long int>(0), Ratio<long int>(1)}), 1);
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(0), Ratio<long int>(1)}, P{Ratio<long int>(1), Ratio<long int>(0)}), -1);
+
+	// almost collinear with large integers, not exact in double
+	const long int big = 1000000000000000000L;
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(big), Ratio<long int>(big)}, P{Ratio<long int>(big-1), Ratio<long int>(big-1)}), 0);
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(big), Ratio<long int>(big)}, P{Ratio<long int>(big-1), Ratio<long int>(big)}), 1);
+	// b.x * c.y - b.y * c.x = 0, then -1/(big-1)^2
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(big, big-1), Ratio<long int>(1)}, P{Ratio<long int>(1), Ratio<long int>(big-1, big)}), 0);
+	ASSERT_EQ (geometry::orientation(P{Ratio<long int>(0), Ratio<long int>(0)}, P{Ratio<long int>(big, big-1), Ratio<long int>(1)}, P{Ratio<long int>(1), Ratio<long int>(big-2, big-1)}), -1);
+
+	// random points against the exact value computed with ratios
+	std::mt19937 generator(0);
+	std::uniform_int_distribution<long int> distribution(-1000,1000);
+	std::uniform_int_distribution<long int> denDistribution(1,1000);
+	auto gen = [&](){ return Ratio<long int>(distribution(generator), denDistribution(generator)); };
+	for(int run=0; run<1000; ++run){
+		const P a{gen(), gen()}, b{a.x + Ratio<long int>(run % 3), gen()}, c{a.x + Ratio<long int>(2 * (run % 3)), gen()};
+		const Ratio<long int> det = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		ASSERT_EQ (geometry::orientation(a, b, c), (det.get_numerator() > 0) - (det.get_numerator() < 0));
+	}
+}
+
+TEST (GeometryKernel, in_circle) {
+	using P = geometry::Point<long int>;
+	const P a{Ratio<long int>(0), Ratio<long int>(0)}, b{Ratio<long int>(1), Ratio<long int>(0)}, c{Ratio<long int>(0), Ratio<long int>(1)};
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(1), Ratio<long int>(1)}), 0);
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(1,2), Ratio<long int>(1,2)}), 1);
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(2), Ratio<long int>(2)}), -1);
+	// (6/5, 3/5) is on the circle, then moved outside by 1e-15
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(6,5), Ratio<long int>(3,5)}), 0);
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(6,5), Ratio<long int>(600000000000001L, 1000000000000000L)}), -1);
+	ASSERT_EQ (geometry::in_circle(a, b, c, P{Ratio<long int>(6,5), Ratio<long int>(599999999999999L, 1000000000000000L)}), 1);
+}
+
+TEST (GeometryKernel, segments_and_hull) {
+	using P = geometry::Point<int>;
+	auto p = [](int x, int y){ return P{Ratio<int>(x), Ratio<int>(y)}; };
+	P out;
+	ASSERT_EQ (geometry::intersection(p(0,0), p(1,1), p(0,1), p(1,0), out), true);
+	ASSERT_EQ (out.x == Ratio<int>(1,2) && out.y == Ratio<int>(1,2), true);
+	ASSERT_EQ (geometry::intersection(p(0,0), p(1,1), p(1,1), p(2,2), out), true);
+	ASSERT_EQ (out.x == Ratio<int>(1) && out.y == Ratio<int>(1), true);
+	ASSERT_EQ (geometry::intersects(p(0,0), p(2,2), p(1,1), p(3,3)), true);
+	ASSERT_EQ (geometry::intersection(p(0,0), p(2,2), p(1,1), p(3,3), out), false);
+	ASSERT_EQ (geometry::intersects(p(0,0), p(1,0), p(0,1), p(1,1)), false);
+	ASSERT_EQ (geometry::intersects(p(0,0), p(2,0), p(1,0), p(1,5)), true);
+
+	std::vector<P> points;
+	for(int i=0; i<=4; ++i) for(int j=0; j<=4; ++j) points.push_back(P{Ratio<int>(i,3), Ratio<int>(j,3)});
+	points.push_back(P{Ratio<int>(2,3), Ratio<int>(-1,5)});
+	const std::vector<P> hull = geometry::convex_hull(points);
+	ASSERT_EQ (hull.size(), 5u);
+	ASSERT_EQ (hull[0].x == Ratio<int>(0) && hull[0].y == Ratio<int>(0), true);
+	ASSERT_EQ (hull[1].x == Ratio<int>(2,3) && hull[1].y == Ratio<int>(-1,5), true);
+	ASSERT_EQ (hull[2].x == Ratio<int>(4,3) && hull[2].y == Ratio<int>(0), true);
+	ASSERT_EQ (hull[4].x == Ratio<int>(0) && hull[4].y == Ratio<int>(4,3), true);
+}
+
+
+/*------------------- RESCALE ---------------------*/
+
+TEST (TimeBaseRescale, rounding) {
+	const Ratio<long int> mpeg(1,90000), ntsc(1001,30000), ms(1,1000);
+	// 3003 ticks of 1/90000 = 1 frame of 1001/30000
+	ASSERT_EQ (rescale(3003, mpeg, ntsc, Rounding::nearest), 1);
+	// 1 tick = 1/90 ms
+	ASSERT_EQ (rescale(1, mpeg, ms, Rounding::down), 0);
+	ASSERT_EQ (rescale(1, mpeg, ms, Rounding::up), 1);
+	ASSERT_EQ (rescale(-1, mpeg, ms, Rounding::down), -1);
+	ASSERT_EQ (rescale(-1, mpeg, ms, Rounding::up), 0);
+	// 45 ticks = 0.5 ms
+	ASSERT_EQ (rescale(45, mpeg, ms, Rounding::nearest), 1);
+	ASSERT_EQ (rescale(45, mpeg, ms, Rounding::half_even), 0);
+	ASSERT_EQ (rescale(135, mpeg, ms, Rounding::half_even), 2);
+	ASSERT_EQ (rescale(-45, mpeg, ms, Rounding::nearest), -1);
+	// ts * 1000 overflows 64 bits, not the 128 bits intermediate
+	const int64_t big = std::numeric_limits<int64_t>::max() / 10;
+	ASSERT_EQ (rescale(big, ms, Ratio<long int>(1,10000), Rounding::nearest), big * 10);
+	ASSERT_EQ (rescale(big, Ratio<long int>(999,1000), Ratio<long int>(1), Rounding::down), static_cast<int64_t>(static_cast<ratio_int128>(big) * 999 / 1000));
+}
+
+TEST (TimeBaseRescale, batch) {
+	std::mt19937_64 generator(0);
+	const Ratio<long int> bases[] = {Ratio<long int>(1,90000), Ratio<long int>(1001,30000), Ratio<long int>(1,1000), Ratio<long int>(1,48000), Ratio<long int>(-7,3)};
+	const Rounding modes[] = {Rounding::toward_zero, Rounding::down, Rounding::up, Rounding::nearest, Rounding::half_even};
+
+	std::vector<int64_t> in(1000), out(1000);
+	for(const Ratio<long int>& from : bases){
+		for(const Ratio<long int>& to : bases){
+			for(const Rounding mode : modes){
+				for(int64_t& ts : in) ts = static_cast<int64_t>(generator() >> 24) - (int64_t(1) << 39);
+				in[0] = 0;
+				rescale(in.data(), in.size(), out.data(), from, to, mode);
+				for(size_t i=0; i<in.size(); ++i) ASSERT_EQ (out[i], rescale(in[i], from, to, mode));
+			}
+		}
+	}
+}
+
+TEST (TimeBaseRescale, out_of_range) {
+	const Ratio<long int> second(1), mpeg(1,90000);
+	// 9*10^18 s in 1/90000 does not fit in 64 bits, with or without the precomputed reciprocal
+	ASSERT_THROW (rescale(9000000000000000000, second, mpeg, Rounding::nearest), std::overflow_error);
+	ASSERT_THROW (Rescaler(second, mpeg, Rounding::nearest)(9000000000000000000), std::overflow_error);
+	// the quotient fits in 64 bits unsigned, not signed
+	ASSERT_THROW (rescale(std::numeric_limits<int64_t>::max(), second, Ratio<long int>(1,2), Rounding::down), std::overflow_error);
+	ASSERT_THROW (Rescaler(second, Ratio<long int>(1,2), Rounding::down)(std::numeric_limits<int64_t>::max()), std::overflow_error);
+	// the rounding crosses the limit
+	// (2^64-1)/3 * 3/2 = 2^63 - 1/2 : only the rounding up crosses the limit
+	const int64_t third = 6148914691236517205;
+	ASSERT_EQ (rescale(third, Ratio<long int>(3,2), second, Rounding::down), std::numeric_limits<int64_t>::max());
+	ASSERT_THROW (rescale(third, Ratio<long int>(3,2), second, Rounding::up), std::overflow_error);
+	ASSERT_THROW (Rescaler(Ratio<long int>(3,2), second, Rounding::up)(third), std::overflow_error);
+	// the minimum of int64_t is reachable
+	ASSERT_EQ (rescale(std::numeric_limits<int64_t>::min(), second, second, Rounding::nearest), std::numeric_limits<int64_t>::min());
+	ASSERT_EQ (Rescaler(second, second, Rounding::nearest)(std::numeric_limits<int64_t>::min()), std::numeric_limits<int64_t>::min());
+	// the reduced factor does not fit in 64 bits
+	const Ratio<long int> large(4611686018427387903), small(1,4611686018427387901);
+	ASSERT_THROW (rescale(1, large, small, Rounding::nearest), std::overflow_error);
+	ASSERT_THROW (Rescaler(large, small, Rounding::nearest), std::overflow_error);
+}
+
+
+/*------------------- COLUMNAR FILE ---------------------*/
+
+TEST (MappedRatioFile, round_trip) {
+	const std::string path = testing::TempDir() + "ratios.col";
+	std::mt19937 generator(5);
+	std::uniform_int_distribution<long int> distribution(-1000000, 1000000);
+	std::vector<Ratio<long int>> ratios;
+	for(int i=0; i<10000; ++i) ratios.emplace_back(distribution(generator), 1 + std::abs(distribution(generator)));
+	write_ratio_file(path, ratios);
+
+	const MappedRatioFile<long int> file(path);
+	ASSERT_EQ (file.size(), ratios.size());
+	ASSERT_TRUE (file.verify());
+	for(size_t i=0; i<ratios.size(); ++i){
+		ASSERT_EQ (file[i], ratios[i]);
+		ASSERT_EQ (file.numerators()[i], ratios[i].get_numerator());
+		ASSERT_EQ (file.denominators()[i], ratios[i].get_denominator());
+	}
+	// the columns are aligned arrays of T inside the mapping
+	ASSERT_EQ (reinterpret_cast<uintptr_t>(file.denominators().data()) % 64, 0u);
+
+	// several views of the same file, moved around
+	MappedRatioFile<long int> other(path);
+	MappedRatioFile<long int> moved(std::move(other));
+	ASSERT_TRUE (other.empty());
+	ASSERT_EQ (moved[42], file[42]);
+
+	// empty file
+	write_ratio_file(path, std::vector<Ratio<long int>>());
+	ASSERT_TRUE (MappedRatioFile<long int>(path).empty());
+	std::remove(path.c_str());
+}
+
+TEST (MappedRatioFile, invalid_files) {
+	const std::string path = testing::TempDir() + "ratios_invalid.col";
+	const std::vector<Ratio<int>> ratios = {Ratio<int>(1,2), Ratio<int>(-3,4), Ratio<int>(5)};
+	write_ratio_file(path, ratios);
+
+	// another integer type
+	ASSERT_THROW (MappedRatioFile<long int> file(path), std::runtime_error);
+	ASSERT_THROW (MappedRatioFile<unsigned int> file(path), std::runtime_error);
+	ASSERT_THROW (MappedRatioFile<int> file(path + ".missing"), std::system_error);
+
+	// a corrupted column is detected by verify(), a corrupted header when the file is opened
+	{
+		std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+		stream.seekp(128);
+		stream.put(7);
+	}
+	ASSERT_FALSE (MappedRatioFile<int>(path).verify());
+	{
+		std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+		stream.seekp(16);
+		stream.put(7);
+	}
+	ASSERT_THROW (MappedRatioFile<int> file(path), std::runtime_error);
+
+	// not a ratio file
+	std::ofstream(path) << "1/2 3/4";
+	ASSERT_THROW (MappedRatioFile<int> file(path), std::runtime_error);
+	std::remove(path.c_str());
+}
+
+
+/*------------------- EXPRESSION GRAPH ---------------------*/
+
+TEST (ExpressionDag, hash_consing) {
+	ExpressionGraph<long int> graph;
+	const auto x = graph.input(Ratio<long int>(1,2));
+	const auto y = graph.input(Ratio<long int>(1,3));
+	ASSERT_NE (x, y);
+
+	// (x+y)^2 - (y+x)*2/3 : x+y is one node, the constant 2/3 too
+	const auto sum = graph.add(x, y);
+	ASSERT_EQ (graph.add(y, x), sum);
+	ASSERT_NE (graph.sub(x, y), graph.sub(y, x));
+	ASSERT_EQ (graph.constant(Ratio<long int>(4,6)), graph.constant(Ratio<long int>(2,3)));
+	const auto f = graph.sub(graph.pow(sum, 2), graph.mul(graph.add(y, x), graph.constant(Ratio<long int>(2,3))));
+	const size_t size = graph.size();
+	ASSERT_EQ (graph.sub(graph.pow(graph.add(x, y), 2), graph.mul(graph.constant(Ratio<long int>(2,3)), sum)), f);
+	ASSERT_EQ (graph.size(), size);
+
+	ASSERT_EQ (graph.value(f), Ratio<long int>(25,36) - Ratio<long int>(5,6) * Ratio<long int>(2,3));
+	ASSERT_EQ (graph.value(graph.div(graph.neg(x), graph.pow(y, -2))), Ratio<long int>(-1,18));
+
+	// the exponent INT_MIN has no positive counterpart in an int
+	const auto minus_one = graph.input(Ratio<long int>(-1));
+	ASSERT_EQ (graph.value(graph.pow(minus_one, std::numeric_limits<int>::min())), Ratio<long int>(1));
+	ASSERT_EQ (graph.value(graph.pow(minus_one, std::numeric_limits<int>::max())), Ratio<long int>(-1));
+}
+
+TEST (ExpressionDag, incremental) {
+	ExpressionGraph<long int> graph;
+	const auto x = graph.input(Ratio<long int>(1));
+	const auto y = graph.input(Ratio<long int>(2));
+	const auto z = graph.input(Ratio<long int>(3));
+	const auto xy = graph.mul(x, y);
+	const auto yz = graph.add(y, z);
+	const auto f = graph.div(xy, yz);
+	ASSERT_EQ (graph.evaluate(), 3u);
+	ASSERT_EQ (graph.value(f), Ratio<long int>(2,5));
+	ASSERT_EQ (graph.evaluate(), 0u);
+
+	// z only changes y+z and f, setting the same value changes nothing
+	graph.set(z, Ratio<long int>(5));
+	graph.set(x, Ratio<long int>(1));
+	ASSERT_EQ (graph.nb_dirty(), 2u);
+	ASSERT_EQ (graph.evaluate(), 2u);
+	ASSERT_EQ (graph.value(f), Ratio<long int>(2,7));
+	ASSERT_EQ (graph.value(xy), Ratio<long int>(2));
+
+	graph.set(y, Ratio<long int>(1,2));
+	ASSERT_EQ (graph.value(f), Ratio<long int>(1,11));
+}
+
+TEST (ExpressionDag, parallel) {
+	// a wide graph : sum of 1/(x+k) for k in [1, 2000], as a balanced tree
+	ExpressionGraph<long int> sequential, parallel;
+	std::vector<size_t> first, second;
+	const auto x1 = sequential.input(Ratio<long int>(1,2));
+	const auto x2 = parallel.input(Ratio<long int>(1,2));
+	for(int k=1; k<=2000; ++k){
+		first.push_back(sequential.pow(sequential.add(x1, sequential.constant(Ratio<long int>(k % 7))), -1));
+		second.push_back(parallel.pow(parallel.add(x2, parallel.constant(Ratio<long int>(k % 7))), -1));
+	}
+	for(int k=0; k<2000; ++k){
+		first.push_back(sequential.mul(first[k], sequential.constant(Ratio<long int>(k))));
+		second.push_back(parallel.mul(second[k], parallel.constant(Ratio<long int>(k))));
+	}
+	while(first.size() > 1){
+		std::vector<size_t> next1, next2;
+		for(size_t i=0; i+1<first.size(); i+=2){
+			next1.push_back(sequential.add(first[i], first[i+1]));
+			next2.push_back(parallel.add(second[i], second[i+1]));
+		}
+		if(first.size() % 2 == 1){
+			next1.push_back(first.back());
+			next2.push_back(second.back());
+		}
+		first.swap(next1);
+		second.swap(next2);
+	}
+	ASSERT_EQ (sequential.evaluate(1), parallel.evaluate(4));
+	ASSERT_EQ (sequential.value(first[0]), parallel.value(second[0]));
+
+	parallel.set(x2, Ratio<long int>(1,3));
+	sequential.set(x1, Ratio<long int>(1,3));
+	parallel.evaluate(4);
+	ASSERT_EQ (sequential.value(first[0]), parallel.value(second[0]));
+}
+
+
+/*------------------- SPARSE MATRIX ---------------------*/
+
+TEST (SparseRational, construction) {
+	using Sparse = SparseMatrix<long int>;
+	const Sparse A(3, 4, {{0, 1, Ratio<long int>(1,2)}, {0, 3, Ratio<long int>(1,3)}, {2, 0, Ratio<long int>(5)},
+	                      {0, 1, Ratio<long int>(1,4)}, {1, 2, Ratio<long int>(1,7)}, {1, 2, Ratio<long int>(-1,7)}});
+	// duplicates added, zeros dropped, rows over their lcm
+	ASSERT_EQ (A.nnz(), 3u);
+	ASSERT_EQ (A.row_denominator(0), 12);
+	ASSERT_EQ (A.row_denominator(1), 1);
+	ASSERT_EQ (A.at(0, 1), Ratio<long int>(3,4));
+	ASSERT_EQ (A.at(0, 3), Ratio<long int>(1,3));
+	ASSERT_EQ (A.at(1, 2), Ratio<long int>(0));
+	ASSERT_EQ (A.at(2, 0), Ratio<long int>(5));
+
+	const Sparse At = A.transpose();
+	ASSERT_EQ (At.nb_rows(), 4u);
+	ASSERT_EQ (At.nnz(), A.nnz());
+	for(size_t i=0; i<3; ++i){
+		for(size_t j=0; j<4; ++j) ASSERT_EQ (At.at(j, i), A.at(i, j));
+	}
+
+	ASSERT_THROW (SparseMatrix<int>(1, 2, {{0, 0, Ratio<int>(1,65536)}, {0, 1, Ratio<int>(1,65537)}}), std::overflow_error);
+	// duplicates whose sum does not fit in an int
+	ASSERT_THROW (SparseMatrix<int>(1, 1, {{0, 0, Ratio<int>(2000000000)}, {0, 0, Ratio<int>(2000000000)}}), std::overflow_error);
+	ASSERT_THROW (SparseMatrix<int>(1, 1, {{0, 0, Ratio<int>(1,65536)}, {0, 0, Ratio<int>(1,65537)}}), std::overflow_error);
+	// their sum fits once reduced
+	const SparseMatrix<int> B(1, 1, {{0, 0, Ratio<int>(1,65536)}, {0, 0, Ratio<int>(65535,65536)}});
+	ASSERT_EQ (B.at(0, 0), Ratio<int>(1));
+}
+
+TEST (SparseRational, multiply_and_ordering) {
+	// a shuffled path : i -- i+1 in the original numbering
+	const size_t n = 3000;
+	std::mt19937 generator(3);
+	std::vector<size_t> label(n);
+	std::iota(label.begin(), label.end(), 0);
+	std::shuffle(label.begin(), label.end(), generator);
+	std::vector<SparseMatrix<long int>::Triplet> entries;
+	for(size_t i=0; i<n; ++i){
+		entries.push_back({label[i], label[i], Ratio<long int>(4)});
+		if(i+1 < n){
+			entries.push_back({label[i], label[i+1], Ratio<long int>(-1, 1 + i % 3)});
+			entries.push_back({label[i+1], label[i], Ratio<long int>(-1, 2)});
+		}
+	}
+	const SparseMatrix<long int> A(n, n, entries);
+	ASSERT_EQ (A.nnz(), 3*n - 2);
+
+	std::vector<Ratio<long int>> x(n);
+	for(size_t j=0; j<n; ++j) x[j] = Ratio<long int>(static_cast<long int>(j % 11) - 5, 1 + j % 4);
+	const std::vector<Ratio<long int>> y = A.multiply(x), y4 = A.multiply(x, 4);
+	ASSERT_EQ (y, y4);
+	for(size_t i=0; i<n; i+=97){
+		Ratio<long int> expected;
+		for(size_t j=0; j<n; ++j) expected += A.at(i, j) * x[j];
+		ASSERT_EQ (y[i], expected);
+	}
+
+	// the ordering gives back a band matrix
+	const std::vector<size_t> position = A.reverse_cuthill_mckee();
+	std::vector<size_t> sorted(position);
+	std::sort(sorted.begin(), sorted.end());
+	for(size_t k=0; k<n; ++k) ASSERT_EQ (sorted[k], k);
+	const SparseMatrix<long int> B = A.permute(position, position);
+	size_t bandwidth = 0;
+	for(size_t i=0; i<n; ++i){
+		for(size_t k=B.row_start(i); k<B.row_start(i+1); ++k) bandwidth = std::max(bandwidth, (B.column(k) > i) ? B.column(k) - i : i - B.column(k));
+	}
+	ASSERT_EQ (bandwidth, 1u);
+	ASSERT_EQ (B.at(position[label[5]], position[label[6]]), A.at(label[5], label[6]));
+}
+
+TEST (SparseRational, solve) {
+	// grid of 50 x 50 nodes numbered at random, each one linked to its 4 neighbors, with a known small solution
+	const size_t side = 50, n = side * side;
+	std::mt19937 generator(9);
+	std::uniform_int_distribution<long int> value(-9, 9);
+	std::uniform_int_distribution<size_t> column(0, n-1);
+	std::vector<size_t> label(n);
+	std::iota(label.begin(), label.end(), 0);
+	std::shuffle(label.begin(), label.end(), generator);
+	std::vector<SparseMatrix<long int>::Triplet> entries;
+	for(size_t i=0; i<n; ++i){
+		entries.push_back({label[i], label[i], Ratio<long int>(20 + value(generator), 3)});
+		if(i % side + 1 < side) entries.push_back({label[i], label[i+1], Ratio<long int>(value(generator), 1 + std::abs(value(generator)))});
+		if(i % side > 0) entries.push_back({label[i], label[i-1], Ratio<long int>(value(generator), 1 + std::abs(value(generator)))});
+		if(i + side < n) entries.push_back({label[i], label[i+side], Ratio<long int>(value(generator), 1 + std::abs(value(generator)))});
+		if(i >= side) entries.push_back({label[i], label[i-side], Ratio<long int>(value(generator), 1 + std::abs(value(generator)))});
+	}
+	const SparseMatrix<long int> A(n, n, entries);
+	std::vector<Ratio<long int>> expected(n);
+	for(size_t j=0; j<n; ++j) expected[j] = Ratio<long int>(value(generator), 1 + std::abs(value(generator)));
+	const std::vector<Ratio<long int>> b = A.multiply(expected);
+
+	std::vector<Ratio<long int>> x;
+	ASSERT_TRUE (modular::solve(A, b, x, 2));
+	ASSERT_EQ (x, expected);
+
+	// same result as the dense solver on a small system, nonsingular : the diagonal dominates the rows (|v| < 1)
+	const size_t m = 30;
+	std::vector<SparseMatrix<long int>::Triplet> small;
+	std::vector<std::vector<Ratio<long int>>> dense(m, std::vector<Ratio<long int>>(m));
+	for(size_t i=0; i<m; ++i){
+		for(int k=0; k<4; ++k){
+			const size_t j = column(generator) % m;
+			const Ratio<long int> v(value(generator), 1 + std::abs(value(generator)));
+			small.push_back({i, j, v});
+			dense[i][j] += v;
+		}
+		small.push_back({i, i, Ratio<long int>(5)});
+		dense[i][i] += Ratio<long int>(5);
+	}
+	std::vector<Ratio<long int>> rhs(m), xs, xd;
+	for(size_t i=0; i<m; ++i){
+		for(size_t j=0; j<m; ++j) rhs[i] += dense[i][j] * expected[j];
+	}
+	ASSERT_TRUE (modular::solve(SparseMatrix<long int>(m, m, small), rhs, xs));
+	ASSERT_TRUE (modular::solve(dense, rhs, xd));
+	ASSERT_EQ (xs, xd);
+	ASSERT_EQ (xd, std::vector<Ratio<long int>>(expected.begin(), expected.begin() + m));
+
+	// singular : two equal rows
+	const SparseMatrix<long int> S(2, 2, {{0, 0, Ratio<long int>(1)}, {0, 1, Ratio<long int>(2)}, {1, 0, Ratio<long int>(1)}, {1, 1, Ratio<long int>(2)}});
+	ASSERT_FALSE (modular::solve(S, std::vector<Ratio<long int>>{Ratio<long int>(1), Ratio<long int>(1)}, x));
+}
+
+
+/*------------------- DECIMAL STRINGS ---------------------*/
+
+// the whole text must be read
+static Ratio<long int> parse_decimal(const std::string &text){
+	Ratio<long int> r;
+	const std::from_chars_result res = from_decimal_chars(text.data(), text.data() + text.size(), r);
+	EXPECT_EQ (res.ec, std::errc());
+	EXPECT_EQ (res.ptr, text.data() + text.size());
+	return r;
+}
+
+template<class R, class... Args>
+static std::string format_decimal(const R &r, Args... args){
+	char buffer[128];
+	const std::to_chars_result res = to_decimal_chars(buffer, buffer + sizeof(buffer), r, args...);
+	EXPECT_EQ (res.ec, std::errc());
+	return std::string(buffer, res.ptr);
+}
+
+TEST (DecimalStrings, parse) {
+	ASSERT_EQ (parse_decimal("12.50"), Ratio<long int>(25,2));
+	ASSERT_EQ (parse_decimal("-0.125"), Ratio<long int>(-1,8));
+	ASSERT_EQ (parse_decimal("42"), Ratio<long int>(42));
+	ASSERT_EQ (parse_decimal(".5"), Ratio<long int>(1,2));
+	ASSERT_EQ (parse_decimal("7."), Ratio<long int>(7));
+	ASSERT_EQ (parse_decimal("0.(142857)"), Ratio<long int>(1,7));
+	ASSERT_EQ (parse_decimal("0.1(6)"), Ratio<long int>(1,6));
+	ASSERT_EQ (parse_decimal("0.(9)"), Ratio<long int>(1));
+	ASSERT_EQ (parse_decimal("-1.00(3)"), Ratio<long int>(-301,300));
+	ASSERT_EQ (parse_decimal("0.000000000000000001"), Ratio<long int>(1, 1000000000000000000));
+	ASSERT_EQ (parse_decimal("1.50000000000000000000000000"), Ratio<long int>(3,2));
+
+	// the number stops at the first character that does not belong to it
+	Ratio<long int> r;
+	const std::string text = "3.25 and more";
+	std::from_chars_result res = from_decimal_chars(text.data(), text.data() + text.size(), r);
+	ASSERT_EQ (res.ec, std::errc());
+	ASSERT_EQ (res.ptr, text.data() + 4);
+	ASSERT_EQ (r, Ratio<long int>(13,4));
+	const std::string unclosed = "0.5(3";
+	res = from_decimal_chars(unclosed.data(), unclosed.data() + unclosed.size(), r);
+	ASSERT_EQ (res.ptr, unclosed.data() + 3);
+	ASSERT_EQ (r, Ratio<long int>(1,2));
+
+	// errors leave the value unchanged
+	for(const std::string bad : {"", "-", ".", "abc", "-.x", "(3)"}){
+		res = from_decimal_chars(bad.data(), bad.data() + bad.size(), r);
+		ASSERT_EQ (res.ec, std::errc::invalid_argument);
+		ASSERT_EQ (res.ptr, bad.data());
+	}
+	Ratio<int> small(5);
+	for(const std::string big : {"3000000000", "0.0000000001", "0.(0000000001)"}){
+		res = from_decimal_chars(big.data(), big.data() + big.size(), small);
+		ASSERT_EQ (res.ec, std::errc::result_out_of_range);
+		ASSERT_EQ (res.ptr, big.data() + big.size());
+	}
+	ASSERT_EQ (small, Ratio<int>(5));
+}
+
+TEST (DecimalStrings, format) {
+	ASSERT_EQ (format_decimal(Ratio<long int>(25,2)), "12.5");
+	ASSERT_EQ (format_decimal(Ratio<long int>(-3)), "-3");
+	ASSERT_EQ (format_decimal(Ratio<long int>(0)), "0");
+	ASSERT_EQ (format_decimal(Ratio<long int>(1,7)), "0.(142857)");
+	ASSERT_EQ (format_decimal(Ratio<long int>(-1,6)), "-0.1(6)");
+	ASSERT_EQ (format_decimal(Ratio<long int>(22,7)), "3.(142857)");
+	ASSERT_EQ (format_decimal(Ratio<long int>(1,3)), "0.(3)");
+	ASSERT_EQ (format_decimal(Ratio<long int>(1,1)), "1");
+	ASSERT_EQ (format_decimal(Ratio<int>::inf()), "inf");
+	// period of length 96 = order of 10 modulo 97
+	ASSERT_EQ (format_decimal(Ratio<long int>(1,97)).size(), 2 + 96 + 2);
+	// a denominator near the limit of the type, where 10*remainder overflows
+	const Ratio<long int> near((1L << 62) - 1, 1L << 62);
+	ASSERT_EQ (format_decimal(near), "0.99999999999999999978315956550289911319850943982601165771484375");
+
+	// fixed number of digits
+	ASSERT_EQ (format_decimal(Ratio<long int>(2,3), 4), "0.6667");
+	ASSERT_EQ (format_decimal(Ratio<long int>(2,3), 4, Rounding::toward_zero), "0.6666");
+	ASSERT_EQ (format_decimal(Ratio<long int>(-2,3), 2, Rounding::down), "-0.67");
+	ASSERT_EQ (format_decimal(Ratio<long int>(-2,3), 2, Rounding::up), "-0.66");
+	ASSERT_EQ (format_decimal(Ratio<long int>(5,2), 0), "3");
+	ASSERT_EQ (format_decimal(Ratio<long int>(5,2), 0, Rounding::half_even), "2");
+	ASSERT_EQ (format_decimal(Ratio<long int>(1,4), 3), "0.250");
+	ASSERT_EQ (format_decimal(Ratio<long int>(19999,200), 1), "100.0");
+	ASSERT_EQ (format_decimal(Ratio<long int>(-19999,200), 1), "-100.0");
+
+	// the buffer is too small
+	char buffer[8];
+	std::to_chars_result res = to_decimal_chars(buffer, buffer + sizeof(buffer), Ratio<long int>(1,7));
+	ASSERT_EQ (res.ec, std::errc::value_too_large);
+	ASSERT_EQ (res.ptr, buffer + sizeof(buffer));
+	// 999.999 -> 1000.00 does not fit in 6 characters
+	res = to_decimal_chars(buffer, buffer + 6, Ratio<long int>(999999,1000), 2);
+	ASSERT_EQ (res.ec, std::errc::value_too_large);
+	res = to_decimal_chars(buffer, buffer + 7, Ratio<long int>(999999,1000), 2);
+	ASSERT_EQ (std::string(buffer, res.ptr), "1000.00");
+}
+
+TEST (DecimalStrings, bulk_round_trip) {
+	// a whole column written in one buffer and read back, without any allocation per value ;
+	// the denominators have short periods, so that the text can be read back in a long int
+	std::default_random_engine generator(7);
+	std::uniform_int_distribution<long int> value(-100000, 100000);
+	const long int denominators[] = {1, 2, 3, 4, 6, 7, 9, 11, 13, 16, 20, 27, 37, 41, 64, 125, 300};
+	std::uniform_int_distribution<size_t> index(0, sizeof(denominators) / sizeof(denominators[0]) - 1);
+	const size_t n = 2000;
+	std::vector<Ratio<long int>> values(n);
+	for(auto &v : values) v = Ratio<long int>(value(generator), denominators[index(generator)]);
+
+	std::vector<char> buffer(n * 32);
+	char *p = buffer.data();
+	for(const auto &v : values){
+		const std::to_chars_result res = to_decimal_chars(p, buffer.data() + buffer.size(), v);
+		ASSERT_EQ (res.ec, std::errc());
+		p = res.ptr;
+		*p++ = ' ';
+	}
+	const char *q = buffer.data();
+	for(const auto &v : values){
+		Ratio<long int> r;
+		const std::from_chars_result res = from_decimal_chars(q, static_cast<const char*>(p), r);
+		ASSERT_EQ (res.ec, std::errc());
+		ASSERT_EQ (r, v);
+		q = res.ptr + 1;
+	}
+}
+
+
+/*------------------- 128 BITS AND UNSIGNED INTEGERS ---------------------*/
+
+#if defined(RATIO_HAS_INT128_TRAITS)
+static std::string int128_text(const ratio_int128 x){
+	char buffer[64];
+	return std::string(buffer, ratio_to_chars(buffer, buffer + sizeof(buffer), x).ptr);
+}
+
+TEST (WideIntegers, gcd_and_printing) {
+	// binary gcd against Euclid's algorithm
+	std::mt19937_64 generator(5);
+	for(int run=0; run<1000; ++run){
+		const ratio_uint128 g = generator() % 1000 + 1;
+		const ratio_uint128 a = g * ((static_cast<ratio_uint128>(generator()) << 32) | generator());
+		const ratio_uint128 b = g * generator();
+		ratio_uint128 x = a, y = b;
+		while(y != 0){
+			const ratio_uint128 r = x % y;
+			x = y;
+			y = r;
+		}
+		ASSERT_TRUE (binary_gcd(a, b) == x);
+		ASSERT_TRUE (ratio_gcd(-static_cast<ratio_int128>(b), static_cast<ratio_int128>(b)) == static_cast<ratio_int128>(b));
+	}
+	ASSERT_TRUE (binary_gcd<ratio_uint128>(0, 12) == 12);
+	ASSERT_TRUE (binary_gcd<ratio_uint128>(12, 0) == 12);
+
+	// decimal text of every width
+	const ratio_int128 max = std::numeric_limits<ratio_int128>::max();
+	ASSERT_EQ (int128_text(max), "170141183460469231731687303715884105727");
+	ASSERT_EQ (int128_text(-max - 1), "-170141183460469231731687303715884105728");
+	ASSERT_EQ (int128_text(0), "0");
+	ASSERT_EQ (int128_text(static_cast<ratio_int128>(10000000000000000000ull) * 10), "100000000000000000000");
+	char buffer[64];
+	const std::to_chars_result res = ratio_to_chars(buffer, buffer + 3, -1234);
+	ASSERT_EQ (res.ec, std::errc::value_too_large);
+	ASSERT_EQ (std::string(buffer, ratio_to_chars(buffer, buffer + sizeof(buffer), std::numeric_limits<unsigned long long>::max()).ptr), "18446744073709551615");
+
+	std::ostringstream stream;
+	stream << Ratio<ratio_int128>(max, 3) << " " << Ratio<ratio_int128>(-1, 3) << " " << Ratio<ratio_int128>::inf();
+	ASSERT_EQ (stream.str(), "170141183460469231731687303715884105727/3 -1/3 inf");
+}
+
+TEST (WideIntegers, int128_arithmetic) {
+	using R = Ratio<ratio_int128>;
+	using RL = Ratio<long int>;
+
+	// same results as Ratio<long int> when they fit
+	std::mt19937 generator(11);
+	std::uniform_int_distribution<long int> value(-1000, 1000);
+	for(int run=0; run<500; ++run){
+		const long int a = value(generator), b = 1 + std::abs(value(generator)), c = value(generator), d = 1 + std::abs(value(generator));
+		const RL x(a, b), y(c, d);
+		const R X(a, b), Y(c, d);
+		ASSERT_TRUE ((X + Y).get_numerator() == (x + y).get_numerator() && (X + Y).get_denominator() == (x + y).get_denominator());
+		ASSERT_TRUE ((X * Y).get_numerator() == (x * y).get_numerator() && (X * Y).get_denominator() == (x * y).get_denominator());
+		ASSERT_EQ (X < Y, x < y);
+		ASSERT_EQ (X > Y, x > y);
+		ASSERT_EQ (X <= Y, x <= y);
+	}
+
+	// exact beyond 64 bits : 3^70/2^70, the sum of 1/k for k <= 40, comparisons without wider type
+	const R p = R::pow(R(3, 2), 70);
+	ASSERT_EQ (int128_text(p.get_numerator()), "2503155504993241601315571986085849");
+	ASSERT_EQ (int128_text(p.get_denominator()), "1180591620717411303424");
+	ASSERT_EQ (R::pow(p, -1), p.inverse());
+	R harmonic = R::zero();
+	for(int k=1; k<=40; ++k) harmonic += R(1, k);
+	std::ostringstream stream;
+	stream << harmonic;
+	ASSERT_EQ (stream.str(), "2078178381193813/485721041551200");
+	const R big(std::numeric_limits<ratio_int128>::max(), std::numeric_limits<ratio_int128>::max() - 1);
+	ASSERT_TRUE (big > R::one());
+	ASSERT_TRUE (-big < -R::one());
+	ASSERT_TRUE (big < R::inf());
+	ASSERT_EQ (big.to_double(), 1.0);
+	ASSERT_EQ (R(1, 3).limit_denominator(2), R(1, 2));
+	ASSERT_EQ (R::simplest_between(R(3, 10), R(2, 5)), R(1, 3));
+
+	// overflow policies work on 128 bits
+	using C = Ratio<ratio_int128, overflow::Checked>;
+	ASSERT_THROW (C::pow(C(1, 3), 81), std::overflow_error);
+	ASSERT_EQ (C::pow(C(-1, 3), 80).get_denominator(), C::pow(C(1, 3), 80).get_denominator());
+}
+#endif
+
+TEST (WideIntegers, unsigned_ratios) {
+	using U = Ratio<unsigned int>;
+	ASSERT_EQ (U(6, 4), U(3, 2));
+	ASSERT_EQ (U(1, 2) + U(1, 3), U(5, 6));
+	ASSERT_EQ (U(5, 6) - U(1, 3), U(1, 2));
+	ASSERT_EQ (U(2, 3) * 6u, U(4));
+	ASSERT_EQ (U(2, 3) / 4u, U(1, 6));
+	ASSERT_EQ (U(2, 3).inverse(), U(3, 2));
+	ASSERT_EQ (U(2, 3).abs(), U(2, 3));
+	ASSERT_TRUE (U(2, 3) < U(3, 4));
+	ASSERT_TRUE (U(4000000000u, 3) > U(3999999999u, 3));
+	ASSERT_EQ (U::pow(U(2, 3), 3), U(8, 27));
+	ASSERT_EQ (U(1, 3).to_double(), 1.0/3.0);
+
+	using ULL = Ratio<unsigned long long int>;
+	const unsigned long long int max = std::numeric_limits<unsigned long long int>::max();
+	ASSERT_TRUE (ULL(max, max - 1) < ULL(max - 1, max - 2));
+	ASSERT_EQ (ULL(max, 3).get_numerator(), max / 3);
+	ASSERT_EQ (ULL(355, 113).limit_denominator(10), ULL(22, 7));
+	std::ostringstream stream;
+	stream << ULL(max, 2);
+	ASSERT_EQ (stream.str(), "18446744073709551615/2");
+
+	// a difference below zero is an overflow for the policies which detect it, Promote computes in unsigned long long
+	using UC = Ratio<unsigned int, overflow::Checked>;
+	ASSERT_THROW (UC(1, 3) - UC(1, 2), std::overflow_error);
+	using UP = Ratio<unsigned int, overflow::Promote>;
+	ASSERT_EQ (UP(4000000000u, 6) + UP(4000000000u, 6), UP(4000000000u, 3));
+	ASSERT_THROW (UP(1, 3) - UP(1, 2), std::overflow_error);
+
+	// decimal text
+	char buffer[32];
+	ASSERT_EQ (std::string(buffer, to_decimal_chars(buffer, buffer + sizeof(buffer), U(1, 6)).ptr), "0.1(6)");
+	U u;
+	const std::string negative = "-0.5", zero = "-0";
+	ASSERT_EQ (from_decimal_chars(negative.data(), negative.data() + negative.size(), u).ec, std::errc::result_out_of_range);
+	ASSERT_EQ (from_decimal_chars(zero.data(), zero.data() + zero.size(), u).ec, std::errc());
+	ASSERT_EQ (u, U(0));
+}